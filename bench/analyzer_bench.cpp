@@ -0,0 +1,177 @@
+#include "bench.hpp"
+#include "../src/analyzer.hpp"
+#include "../src/file_reader.hpp"
+
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+    void analyzer_load(Bench::State &state)
+    {
+        for (auto _ : state)
+        {
+            Analyzer analyzer(state.get_corpus().directory_path, false);
+            Bench::do_not_optimize(analyzer);
+        }
+
+        state.set_bytes_processed(state.get_corpus().text.size());
+    }
+
+    void analyzer_load_from_index(Bench::State &state)
+    {
+        std::filesystem::path index_path = std::filesystem::temp_directory_path() / "textanalysis_bench.tai";
+        Analyzer(state.get_corpus().directory_path, false).save_index(index_path.string());
+
+        for (auto _ : state)
+        {
+            Analyzer analyzer(std::make_shared<const CorpusIndex>(index_path.string()), std::vector<std::wstring>(), 0);
+            Bench::do_not_optimize(analyzer);
+        }
+
+        std::filesystem::remove(index_path);
+        state.set_bytes_processed(state.get_corpus().text.size());
+    }
+
+    void analyzer_load_incremental(Bench::State &state)
+    {
+        // Every iteration finds the files unchanged, so only the cache is read and written again
+        std::filesystem::path cache_path = std::filesystem::temp_directory_path() / "textanalysis_bench_cache.tai";
+        std::filesystem::remove(cache_path);
+        Analyzer(state.get_corpus().directory_path, std::vector<std::wstring>(), false, 0, cache_path.string());
+
+        for (auto _ : state)
+        {
+            Analyzer analyzer(state.get_corpus().directory_path, std::vector<std::wstring>(), false, 0, cache_path.string());
+            Bench::do_not_optimize(analyzer);
+        }
+
+        std::filesystem::remove(cache_path);
+        state.set_bytes_processed(state.get_corpus().text.size());
+    }
+
+    void analyzer_generate_n_gram(Bench::State &state)
+    {
+        Analyzer analyzer(state.get_corpus().directory_path, false);
+
+        for (auto _ : state)
+        {
+            // Setting the filter drops the kept results, so every iteration counts the n-grams again
+            analyzer.set_filters(std::vector<std::wstring>());
+            Bench::do_not_optimize(analyzer.generate_n_gram(2, 5));
+        }
+
+        state.set_bytes_processed(state.get_corpus().text.size());
+    }
+
+    void analyzer_get_unique_word_count(Bench::State &state)
+    {
+        Analyzer analyzer(state.get_corpus().directory_path, false);
+
+        for (auto _ : state)
+        {
+            analyzer.set_filters(std::vector<std::wstring>());
+            Bench::do_not_optimize(analyzer.get_unique_word_count());
+        }
+
+        state.set_bytes_processed(state.get_corpus().text.size());
+    }
+
+    void analyzer_report(Bench::State &state)
+    {
+        Analyzer analyzer(state.get_corpus().directory_path, false);
+
+        // Every output of a default run, n-grams are requested twice as by a report with and without them per file
+        for (auto _ : state)
+        {
+            analyzer.set_filters(std::vector<std::wstring>());
+            Bench::do_not_optimize(analyzer.get_word_count());
+            Bench::do_not_optimize(analyzer.get_unique_word_count());
+            Bench::do_not_optimize(analyzer.generate_n_gram(2, 5));
+            Bench::do_not_optimize(analyzer.generate_n_gram(2, 10));
+        }
+
+        state.set_bytes_processed(state.get_corpus().text.size());
+    }
+
+    void analyzer_generate_word_cloud_per_file(Bench::State &state)
+    {
+        Analyzer analyzer(state.get_corpus().directory_path, false);
+        std::filesystem::path target = std::filesystem::temp_directory_path() / "textanalysis_bench_clouds";
+
+        for (auto _ : state)
+        {
+            analyzer.generate_word_cloud_per_file(target.string(), 0);
+        }
+
+        std::filesystem::remove_all(target);
+        state.set_bytes_processed(state.get_corpus().text.size());
+    }
+
+    // Size of a single file of the small file corpus
+    const std::size_t SMALL_FILE_SIZE = 4096;
+
+    /**
+     * @brief Splits the corpus into files of a few kilobytes, cut at new lines or spaces so no word is split.
+     *
+     * @return std::size_t Number of written files
+     */
+    std::size_t write_small_files(const std::string &text, const std::filesystem::path &directory)
+    {
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+
+        std::size_t count = 0;
+        for (std::size_t start = 0; start < text.size(); ++count)
+        {
+            std::size_t end = text.find_first_of(" \n", std::min(start + SMALL_FILE_SIZE, text.size() - 1));
+            end = (end == std::string::npos) ? text.size() : end + 1;
+
+            // Files are spread over subdirectories, as they would be in a real corpus
+            std::filesystem::path path = directory / std::to_string(count % 64) / ("file_" + std::to_string(count) + ".txt");
+            std::filesystem::create_directories(path.parent_path());
+            std::ofstream(path, std::ios::binary).write(text.data() + start, end - start);
+
+            start = end;
+        }
+
+        return count;
+    }
+
+    // Registers loading of a corpus of many small files for every file reader
+    const bool small_files_registered = [] {
+        for (auto backend : {FileReader::Backend::MMAP, FileReader::Backend::PREAD, FileReader::Backend::IO_URING})
+        {
+            Bench::register_benchmark("analyzer/load_small_files/" + FileReader::get_name(backend), [backend](Bench::State &state) {
+                std::filesystem::path directory = std::filesystem::temp_directory_path() / "textanalysis_bench_small_files";
+                std::size_t files = write_small_files(state.get_corpus().text, directory);
+
+                FileReader::Backend previous = FileReader::get_backend();
+                FileReader::set_backend(backend);
+
+                for (auto _ : state)
+                {
+                    Analyzer analyzer(directory.string(), false);
+                    Bench::do_not_optimize(analyzer);
+                }
+
+                FileReader::set_backend(previous);
+                std::filesystem::remove_all(directory);
+
+                state.set_bytes_processed(state.get_corpus().text.size());
+                state.set_items_processed(files);
+            },
+                                      256);
+        }
+
+        return true;
+    }();
+}; // namespace
+
+BENCHMARK("analyzer/load", analyzer_load);
+BENCHMARK("analyzer/load_from_index", analyzer_load_from_index);
+BENCHMARK("analyzer/load_incremental", analyzer_load_incremental);
+BENCHMARK("analyzer/generate_n_gram/2", analyzer_generate_n_gram);
+BENCHMARK("analyzer/get_unique_word_count", analyzer_get_unique_word_count);
+BENCHMARK("analyzer/report", analyzer_report);
+BENCHMARK("analyzer/generate_word_cloud_per_file", analyzer_generate_word_cloud_per_file);
@@ -0,0 +1,373 @@
+#include "bench.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    // Number of calls of operator new since the start of the program, counted by the replacements below
+    std::atomic<std::size_t> allocation_count{0};
+
+    // Registered benchmark
+    struct Benchmark
+    {
+        std::string name;
+        std::function<void(Bench::State &)> function;
+        std::size_t max_megabytes;
+    };
+
+    // Function local static avoids the static initialization order problem with registrations in other files
+    std::vector<Benchmark> &get_benchmarks()
+    {
+        static std::vector<Benchmark> benchmarks;
+        return benchmarks;
+    }
+
+    // Number of files the corpus is split into for benchmarks of whole directories
+    const int CORPUS_FILES = 16;
+
+    /**
+     * @brief Builds a synthetic corpus by repeating every file of a directory until the size is reached.
+     */
+    std::string generate_text(std::string directory_path, std::size_t size)
+    {
+        std::vector<std::string> sources;
+
+        for (const auto &entry : fs::recursive_directory_iterator(directory_path))
+        {
+            if (entry.is_regular_file())
+            {
+                std::ifstream file(entry.path(), std::ios::binary);
+                std::stringstream content;
+                content << file.rdbuf();
+
+                // Files are joined by a new line so that words do not merge together
+                sources.push_back(content.str() + "\n");
+            }
+        }
+
+        if (sources.empty())
+        {
+            throw std::invalid_argument("No input files found in \"" + directory_path + "\"!");
+        }
+
+        std::string text;
+        text.reserve(size + sources.front().size());
+
+        while (text.size() < size)
+        {
+            for (const auto &source : sources)
+            {
+                text += source;
+            }
+        }
+
+        return text;
+    }
+
+    /**
+     * @brief Writes text into a file, throws if it cannot be written.
+     */
+    void write_file(const fs::path &path, const char *data, std::size_t size)
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(data, size);
+
+        if (!file)
+        {
+            throw std::runtime_error("Could not write corpus to " + path.string() + ".");
+        }
+    }
+
+    /**
+     * @brief Generates the corpus and writes it to a temporary directory.
+     */
+    Bench::Corpus generate_corpus(std::string source_path, std::size_t megabytes)
+    {
+        Bench::Corpus corpus;
+        corpus.text = generate_text(source_path, megabytes * 1024 * 1024);
+
+        fs::path root = fs::temp_directory_path() / ("textanalysis_bench_" + std::to_string(megabytes));
+        fs::remove_all(root);
+        fs::create_directories(root / "files");
+
+        corpus.file_path = (root / "corpus.txt").string();
+        corpus.directory_path = (root / "files").string();
+
+        write_file(corpus.file_path, corpus.text.data(), corpus.text.size());
+
+        // Parts are cut at new lines, so no word is split between two files
+        std::size_t part_size = corpus.text.size() / CORPUS_FILES + 1;
+        std::size_t start = 0;
+        for (int i = 0; start < corpus.text.size(); ++i)
+        {
+            std::size_t end = corpus.text.find('\n', std::min(start + part_size, corpus.text.size() - 1));
+            end = (end == std::string::npos) ? corpus.text.size() : end + 1;
+
+            write_file(root / "files" / ("part_" + std::to_string(i) + ".txt"), corpus.text.data() + start, end - start);
+            start = end;
+        }
+
+        return corpus;
+    }
+
+    /**
+     * @brief Reads a value in kilobytes from /proc/self/status.
+     */
+    std::size_t read_status_kilobytes(const std::string &key)
+    {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+
+        while (std::getline(status, line))
+        {
+            if (line.compare(0, key.size(), key) == 0)
+            {
+                return std::stoul(line.substr(key.size() + 1));
+            }
+        }
+
+        return 0;
+    }
+
+    /**
+     * @brief Resets the peak resident memory of the process, if the platform supports it.
+     *
+     * @retval Current resident memory in kilobytes
+     */
+    std::size_t reset_peak_memory()
+    {
+        // Writing 5 to clear_refs resets VmHWM on Linux
+        std::ofstream clear_refs("/proc/self/clear_refs");
+        clear_refs << "5";
+
+        return read_status_kilobytes("VmRSS:");
+    }
+
+    /**
+     * @brief Returns the peak resident memory of the process.
+     *
+     * @retval Peak resident memory in kilobytes
+     */
+    std::size_t get_peak_memory()
+    {
+        std::size_t peak = read_status_kilobytes("VmHWM:");
+
+#if defined(__unix__) || defined(__APPLE__)
+        // Peak for the whole lifetime of the process where /proc is not available
+        if (peak == 0)
+        {
+            struct rusage usage;
+            getrusage(RUSAGE_SELF, &usage);
+            peak = usage.ru_maxrss;
+        }
+#endif
+
+        return peak;
+    }
+
+    /**
+     * @brief Splits a list of numbers separated by ",".
+     */
+    std::vector<std::size_t> parse_sizes(const std::string &list)
+    {
+        std::vector<std::size_t> sizes;
+        std::stringstream stream(list);
+        std::string size;
+
+        while (std::getline(stream, size, ','))
+        {
+            sizes.push_back(std::stoul(size));
+        }
+
+        return sizes;
+    }
+}; // namespace
+
+// Every other form of operator new and delete calls these, so replacing them counts all allocations of the program
+void *operator new(std::size_t size)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+
+    if (void *pointer = std::malloc(size == 0 ? 1 : size))
+    {
+        return pointer;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+Bench::State::iterator Bench::State::begin()
+{
+    this->allocations_start = allocation_count.load(std::memory_order_relaxed);
+    this->start = std::chrono::steady_clock::now();
+    return iterator(this, this->iterations);
+}
+
+Bench::State::iterator Bench::State::end()
+{
+    return iterator(this, 0);
+}
+
+const Bench::Corpus &Bench::State::get_corpus()
+{
+    return this->corpus;
+}
+
+void Bench::State::set_bytes_processed(std::size_t bytes)
+{
+    this->bytes_processed = bytes;
+}
+
+std::size_t Bench::State::get_bytes_processed()
+{
+    return this->bytes_processed;
+}
+
+void Bench::State::set_items_processed(std::size_t items)
+{
+    this->items_processed = items;
+}
+
+std::size_t Bench::State::get_items_processed()
+{
+    return this->items_processed;
+}
+
+double Bench::State::get_seconds_per_iteration()
+{
+    return this->seconds / this->iterations;
+}
+
+double Bench::State::get_allocations_per_iteration()
+{
+    return static_cast<double>(this->allocations) / this->iterations;
+}
+
+void Bench::State::stop()
+{
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - this->start;
+    this->seconds = elapsed.count();
+    this->allocations = allocation_count.load(std::memory_order_relaxed) - this->allocations_start;
+}
+
+bool Bench::register_benchmark(std::string name, std::function<void(Bench::State &)> function, std::size_t max_megabytes)
+{
+    get_benchmarks().push_back(Benchmark{name, function, max_megabytes});
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        std::string source_path = BENCH_CORPUS_DIR;
+        std::vector<std::size_t> sizes{1, 16, 256, 1024};
+        std::string filter;
+        int iterations = 3;
+
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+
+            if (arg == "--corpus" && i + 1 < argc)
+            {
+                source_path = argv[++i];
+            }
+            else if (arg == "--sizes" && i + 1 < argc)
+            {
+                sizes = parse_sizes(argv[++i]);
+            }
+            else if (arg == "--filter" && i + 1 < argc)
+            {
+                filter = argv[++i];
+            }
+            else if (arg == "--iterations" && i + 1 < argc)
+            {
+                iterations = std::max(1, std::stoi(argv[++i]));
+            }
+            else
+            {
+                std::cout << "Usage: textanalysis_bench [--corpus /dir/path] [--sizes 1,16,256,1024] [--filter name] [--iterations 3]\n";
+                return (arg == "-h" || arg == "--help") ? 0 : 1;
+            }
+        }
+
+        std::cout << std::left << std::setw(48) << "Benchmark"
+                  << std::right << std::setw(14) << "Time" << std::setw(17) << "Throughput" << std::setw(14) << "Peak memory" << std::setw(14) << "Allocations" << std::setw(14) << "Items/s" << "\n";
+
+        for (auto megabytes : sizes)
+        {
+            Bench::Corpus corpus = generate_corpus(source_path, megabytes);
+
+            for (auto &benchmark : get_benchmarks())
+            {
+                bool is_too_large = benchmark.max_megabytes > 0 && megabytes > benchmark.max_megabytes;
+                bool is_filtered = !filter.empty() && benchmark.name.find(filter) == std::string::npos;
+
+                if (is_too_large || is_filtered)
+                {
+                    continue;
+                }
+
+                std::size_t memory_before = reset_peak_memory();
+
+                Bench::State state(corpus, iterations);
+                benchmark.function(state);
+
+                // Memory used on top of the corpus and other benchmarks
+                std::size_t peak = get_peak_memory();
+                double peak_megabytes = (peak > memory_before) ? (peak - memory_before) / 1024.0 : 0;
+
+                double seconds = state.get_seconds_per_iteration();
+                double throughput = state.get_bytes_processed() / (1024.0 * 1024.0) / seconds;
+
+                std::cout << std::left << std::setw(48) << (benchmark.name + "/" + std::to_string(megabytes) + "MB")
+                          << std::right << std::fixed
+                          << std::setw(11) << std::setprecision(3) << seconds * 1000 << " ms"
+                          << std::setw(12) << std::setprecision(1) << throughput << " MB/s"
+                          << std::setw(11) << std::setprecision(1) << peak_megabytes << " MB"
+                          << std::setw(14) << std::setprecision(0) << state.get_allocations_per_iteration();
+
+                // Only benchmarks processing countable items, like files, report their rate
+                if (state.get_items_processed() > 0)
+                {
+                    std::cout << std::setw(14) << std::setprecision(0) << state.get_items_processed() / seconds;
+                }
+
+                std::cout << "\n";
+            }
+
+            fs::remove_all(fs::path(corpus.file_path).parent_path());
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Benchmark failed due to an error:\t" << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+
+namespace Bench
+{
+    // Synthetic corpus of a single size, generated from example input files
+    struct Corpus
+    {
+        // Whole corpus in memory
+        std::string text;
+
+        // Whole corpus written into a single file
+        std::string file_path;
+
+        // Corpus split into several files inside of a directory
+        std::string directory_path;
+    };
+
+    /**
+     * @brief State of a running benchmark, iterating over it runs and times the measured code.
+     * @note  Code before the loop is setup and is not measured.
+     */
+    class State
+    {
+    private:
+        const Bench::Corpus &corpus;
+        int iterations;
+        std::size_t bytes_processed = 0;
+        std::size_t items_processed = 0;
+
+        std::chrono::steady_clock::time_point start;
+        double seconds = 0;
+
+        // Number of allocations made by the measured code
+        std::size_t allocations_start = 0;
+        std::size_t allocations = 0;
+
+    public:
+        // Value of the loop variable, marked so that unused loop variables do not cause warnings
+        struct [[maybe_unused]] iteration
+        {
+        };
+
+        // Iterator counting down the remaining iterations, the timer stops when it reaches the end
+        class iterator
+        {
+        private:
+            State *state;
+            int remaining;
+
+        public:
+            iterator(State *state, int remaining) : state(state), remaining(remaining) {}
+
+            iteration operator*() const
+            {
+                return iteration{};
+            }
+
+            iterator &operator++()
+            {
+                --this->remaining;
+                return *this;
+            }
+
+            bool operator!=(const iterator &other)
+            {
+                if (this->remaining == other.remaining)
+                {
+                    this->state->stop();
+                    return false;
+                }
+
+                return true;
+            }
+        };
+
+        /**
+         * @brief Creates the state of a benchmark.
+         *
+         * @param corpus        Corpus used by the benchmark
+         * @param iterations    Number of runs of the measured code
+         */
+        State(const Bench::Corpus &corpus, int iterations) : corpus(corpus), iterations(iterations) {}
+
+        /**
+         * @brief Starts the timer.
+         */
+        iterator begin();
+
+        /**
+         * @brief End of the loop over iterations.
+         */
+        iterator end();
+
+        /**
+         * @brief Returns the corpus used by the benchmark.
+         *
+         * @return const Bench::Corpus& Corpus
+         */
+        const Bench::Corpus &get_corpus();
+
+        /**
+         * @brief Sets the number of bytes processed by a single iteration, used to compute throughput.
+         *
+         * @param bytes Number of bytes
+         */
+        void set_bytes_processed(std::size_t bytes);
+
+        /**
+         * @brief Returns the number of bytes processed by a single iteration.
+         *
+         * @return std::size_t Number of bytes
+         */
+        std::size_t get_bytes_processed();
+
+        /**
+         * @brief Sets the number of items, for example files, processed by a single iteration.
+         *
+         * @param items Number of items
+         */
+        void set_items_processed(std::size_t items);
+
+        /**
+         * @brief Returns the number of items processed by a single iteration.
+         *
+         * @return std::size_t Number of items, 0 if not set
+         */
+        std::size_t get_items_processed();
+
+        /**
+         * @brief Returns the mean time of a single iteration.
+         *
+         * @return double Time in seconds
+         */
+        double get_seconds_per_iteration();
+
+        /**
+         * @brief Returns the mean number of allocations made by a single iteration.
+         *
+         * @return double Number of calls of operator new
+         */
+        double get_allocations_per_iteration();
+
+    private:
+        /**
+         * @brief Stops the timer.
+         */
+        void stop();
+    };
+
+    /**
+     * @brief Registers a benchmark to be run for every corpus size.
+     *
+     * @param name          Name of the benchmark
+     * @param function      Benchmarked function
+     * @param max_megabytes Largest corpus the benchmark runs on, 0 for no limit. Used for slow reference implementations
+     *
+     * @return bool Always true, allows registration in static initializers
+     */
+    bool register_benchmark(std::string name, std::function<void(Bench::State &)> function, std::size_t max_megabytes);
+
+    /**
+     * @brief Keeps the compiler from removing computation of a value that is never used.
+     */
+    template <typename T>
+    void do_not_optimize(const T &value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile(""
+                     :
+                     : "g"(&value)
+                     : "memory");
+#else
+        static volatile const void *sink;
+        sink = &value;
+#endif
+    }
+}; // namespace Bench
+
+// Registers a function void(Bench::State &) as a benchmark
+#define BENCHMARK(name, function) static const bool function##_registered = Bench::register_benchmark(name, function, 0)
+
+// Registers a benchmark which only runs on corpora up to a size in megabytes
+#define BENCHMARK_LIMITED(name, function, max_megabytes) static const bool function##_registered = Bench::register_benchmark(name, function, max_megabytes)
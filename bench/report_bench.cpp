@@ -0,0 +1,148 @@
+#include "bench.hpp"
+#include "../src/output_writer.hpp"
+#include "../src/report.hpp"
+
+#include <codecvt>
+#include <locale>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Number of files of the report, results of the files do not depend on the corpus
+    const std::size_t REPORT_FILES = 100000;
+
+    /**
+     * @brief Stream buffer which drops everything, so only formatting is measured.
+     */
+    template <typename Char>
+    class NullBuffer : public std::basic_streambuf<Char>
+    {
+    protected:
+        std::streamsize xsputn(const Char *, std::streamsize count) override { return count; }
+        typename std::basic_streambuf<Char>::int_type overflow(typename std::basic_streambuf<Char>::int_type value) override { return value; }
+    };
+
+    struct file_result
+    {
+        std::string path;
+        long count;
+        std::vector<Statistics::n_gram> n_grams;
+    };
+
+    /**
+     * @brief Creates results of many files with paths, counts and n-grams of a realistic size.
+     */
+    std::vector<file_result> create_results()
+    {
+        std::vector<file_result> results;
+        results.reserve(REPORT_FILES);
+
+        for (std::size_t i = 0; i < REPORT_FILES; ++i)
+        {
+            file_result result{"corpus/part_" + std::to_string(i % 64) + "/file_" + std::to_string(i) + ".txt", static_cast<long>(i * 37 % 100000), {}};
+
+            for (long rank = 0; rank < 5; ++rank)
+            {
+                result.n_grams.push_back(Statistics::n_gram{L"slovo" + std::to_wstring(rank) + L" řekl", 100 - rank});
+            }
+
+            results.push_back(result);
+        }
+
+        return results;
+    }
+
+    /**
+     * @brief Reference implementation of the original output, every line is formatted into a wide string first.
+     */
+    void report_wide_lines(Bench::State &state)
+    {
+        std::vector<file_result> results = create_results();
+
+        NullBuffer<wchar_t> buffer;
+        std::wostream stream(&buffer);
+        stream.imbue(std::locale(std::locale::classic(), new std::codecvt_utf8<wchar_t>()));
+
+        for (auto _ : state)
+        {
+            std::vector<std::wstring> analysis;
+
+            analysis.push_back(L"Number of words per file:");
+            for (const auto &result : results)
+            {
+                analysis.push_back(L"\t" + std::wstring(result.path.begin(), result.path.end()) + L"\t" + std::to_wstring(result.count));
+            }
+
+            analysis.push_back(L"5 most frequent 2-ngrams per file are:");
+            for (const auto &result : results)
+            {
+                std::wstring file_gram = L"\t" + std::wstring(result.path.begin(), result.path.end()) + L"\t";
+
+                for (const auto &gram : result.n_grams)
+                {
+                    file_gram += gram.value + L"(" + std::to_wstring(gram.count) + L"), ";
+                }
+
+                analysis.push_back(file_gram);
+            }
+
+            for (const auto &line : analysis)
+            {
+                stream << line << "\n";
+            }
+        }
+
+        state.set_items_processed(REPORT_FILES);
+    }
+
+    /**
+     * @brief Writes the same results through a report of the format.
+     */
+    void report_format(Bench::State &state, Report::Format format)
+    {
+        std::vector<file_result> results = create_results();
+
+        NullBuffer<char> buffer;
+        std::ostream stream(&buffer);
+
+        for (auto _ : state)
+        {
+            OutputWriter writer(stream);
+            std::unique_ptr<Report> report = Report::create(format, writer);
+
+            report->begin_section(Report::section{Report::Metric::WORDS, true, 0, 0});
+            for (const auto &result : results)
+            {
+                report->write_count(result.path, result.count);
+            }
+
+            report->begin_section(Report::section{Report::Metric::N_GRAMS, true, 2, 5});
+            for (const auto &result : results)
+            {
+                report->write_n_grams(result.path, result.n_grams);
+            }
+
+            report->finish();
+        }
+
+        state.set_items_processed(REPORT_FILES);
+    }
+
+    void report_text(Bench::State &state) { report_format(state, Report::Format::TEXT); }
+    void report_json(Bench::State &state) { report_format(state, Report::Format::JSON); }
+    void report_csv(Bench::State &state) { report_format(state, Report::Format::CSV); }
+    void report_tsv(Bench::State &state) { report_format(state, Report::Format::TSV); }
+    void report_msgpack(Bench::State &state) { report_format(state, Report::Format::MSGPACK); }
+}; // namespace
+
+// Results are the same for every corpus, so they run only with the smallest one
+BENCHMARK_LIMITED("report/wide_lines", report_wide_lines, 1);
+BENCHMARK_LIMITED("report/text", report_text, 1);
+BENCHMARK_LIMITED("report/json", report_json, 1);
+BENCHMARK_LIMITED("report/csv", report_csv, 1);
+BENCHMARK_LIMITED("report/tsv", report_tsv, 1);
+BENCHMARK_LIMITED("report/msgpack", report_msgpack, 1);
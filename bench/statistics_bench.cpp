@@ -0,0 +1,119 @@
+#include "bench.hpp"
+#include "../src/statistics.hpp"
+#include "../src/stop_words.hpp"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+    void statistics_load(Bench::State &state)
+    {
+        Statistics stat(state.get_corpus().file_path, false);
+
+        for (auto _ : state)
+        {
+            stat.load();
+        }
+
+        state.set_bytes_processed(state.get_corpus().text.size());
+    }
+
+    void statistics_load_ignore_case(Bench::State &state)
+    {
+        Statistics stat(state.get_corpus().file_path, true);
+
+        for (auto _ : state)
+        {
+            stat.load();
+        }
+
+        state.set_bytes_processed(state.get_corpus().text.size());
+    }
+
+    void statistics_load_streaming(Bench::State &state)
+    {
+        Statistics stat(state.get_corpus().file_path, false);
+        stat.set_streaming(2);
+
+        for (auto _ : state)
+        {
+            stat.load();
+        }
+
+        state.set_bytes_processed(state.get_corpus().text.size());
+    }
+
+    void statistics_get_word_count(Bench::State &state)
+    {
+        Statistics stat(state.get_corpus().file_path, false);
+        stat.load();
+
+        for (auto _ : state)
+        {
+            // Setting the filter drops the kept results, so every iteration counts the words again
+            stat.set_filter(std::vector<std::wstring>());
+            Bench::do_not_optimize(stat.get_word_count());
+        }
+
+        state.set_bytes_processed(state.get_corpus().text.size());
+    }
+
+    void statistics_get_word_count_stop_words(Bench::State &state)
+    {
+        std::vector<std::wstring> stop_words = StopWords::get("english");
+        Statistics stat(state.get_corpus().file_path, stop_words, false);
+        stat.load();
+
+        for (auto _ : state)
+        {
+            stat.set_filter(stop_words);
+            Bench::do_not_optimize(stat.get_word_count());
+        }
+
+        state.set_bytes_processed(state.get_corpus().text.size());
+    }
+
+    void statistics_get_unique_word_count(Bench::State &state)
+    {
+        Statistics stat(state.get_corpus().file_path, false);
+        stat.load();
+
+        for (auto _ : state)
+        {
+            stat.set_filter(std::vector<std::wstring>());
+            Bench::do_not_optimize(stat.get_unqiue_word_count());
+        }
+
+        state.set_bytes_processed(state.get_corpus().text.size());
+    }
+
+    // Registers get_n_grams for every n-gram size from 1 to 5
+    const bool n_grams_registered = [] {
+        for (int size = 1; size <= 5; ++size)
+        {
+            Bench::register_benchmark("statistics/get_n_grams/" + std::to_string(size), [size](Bench::State &state) {
+                Statistics stat(state.get_corpus().file_path, false);
+                stat.load();
+
+                for (auto _ : state)
+                {
+                    stat.set_filter(std::vector<std::wstring>());
+                    Bench::do_not_optimize(stat.get_n_grams(size, 5));
+                }
+
+                state.set_bytes_processed(state.get_corpus().text.size());
+            },
+                                      0);
+        }
+
+        return true;
+    }();
+}; // namespace
+
+BENCHMARK("statistics/load", statistics_load);
+BENCHMARK("statistics/load_ignore_case", statistics_load_ignore_case);
+BENCHMARK("statistics/load_streaming", statistics_load_streaming);
+BENCHMARK("statistics/get_word_count", statistics_get_word_count);
+BENCHMARK("statistics/get_word_count_stop_words", statistics_get_word_count_stop_words);
+BENCHMARK("statistics/get_unqiue_word_count", statistics_get_unique_word_count);
@@ -0,0 +1,214 @@
+#include "bench.hpp"
+#include "../src/mapped_file.hpp"
+#include "../src/tokenizer.hpp"
+#include "../src/utf8.hpp"
+
+#include <codecvt>
+#include <fstream>
+#include <locale>
+#include <regex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    /**
+     * @brief Reference implementation of the original std::wregex based word splitting.
+     */
+    std::vector<std::wstring> regex_split(const std::string &content)
+    {
+        std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+        std::wstring wide_content = converter.from_bytes(content);
+
+        std::vector<std::wstring> result;
+        std::wregex delimiters(L"[^\\.,:;!”„“=…?() \n\"]+");
+        auto file_begin = std::wsregex_iterator(wide_content.begin(), wide_content.end(), delimiters);
+        auto file_end = std::wsregex_iterator();
+
+        for (std::wsregex_iterator it = file_begin; it != file_end; ++it)
+        {
+            result.push_back((*it).str());
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Splitting with every word decoded into a wide string.
+     */
+    std::vector<std::wstring> tokenizer_split(const std::string &content)
+    {
+        std::vector<std::wstring> result;
+
+        Tokenizer::tokenize(content.data(), content.size(), [&](const Tokenizer::Token &token) {
+            result.push_back(UTF8::decode(std::string_view(content.data() + token.offset, token.length)));
+        });
+
+        return result;
+    }
+
+    /**
+     * @brief Only finds the word boundaries without creating any strings.
+     */
+    std::size_t count_words(const char *data, std::size_t size)
+    {
+        std::size_t count = 0;
+        Tokenizer::tokenize(data, size, [&](const Tokenizer::Token &) { ++count; });
+        return count;
+    }
+
+    void tokenize_regex(Bench::State &state)
+    {
+        const std::string &text = state.get_corpus().text;
+
+        for (auto _ : state)
+        {
+            Bench::do_not_optimize(regex_split(text));
+        }
+
+        state.set_bytes_processed(text.size());
+    }
+
+    void tokenize_wide_words(Bench::State &state)
+    {
+        const std::string &text = state.get_corpus().text;
+
+        for (auto _ : state)
+        {
+            Bench::do_not_optimize(tokenizer_split(text));
+        }
+
+        state.set_bytes_processed(text.size());
+    }
+
+    void tokenize_spans(Bench::State &state)
+    {
+        const std::string &text = state.get_corpus().text;
+
+        for (auto _ : state)
+        {
+            Bench::do_not_optimize(count_words(text.data(), text.size()));
+        }
+
+        state.set_bytes_processed(text.size());
+    }
+
+    /**
+     * @brief Repeats a translation of the_egg until the text is as large as the corpus.
+     */
+    std::string read_language(const std::string &language, std::size_t size)
+    {
+        std::ifstream file(std::string(BENCH_CORPUS_DIR) + "/the_egg/the_egg_" + language + ".txt", std::ios::binary);
+        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        if (content.empty())
+        {
+            throw std::runtime_error("Could not read the_egg in " + language + "!");
+        }
+
+        std::string text;
+        text.reserve(size + content.size());
+        while (text.size() < size)
+        {
+            text += content;
+        }
+
+        return text;
+    }
+
+    void tokenize_language(Bench::State &state, const std::string &language, Delimiters::Kernel kernel)
+    {
+        std::string text = read_language(language, state.get_corpus().text.size());
+
+        Delimiters::Kernel previous = Delimiters::get_kernel();
+        Delimiters::set_kernel(kernel);
+
+        for (auto _ : state)
+        {
+            Bench::do_not_optimize(count_words(text.data(), text.size()));
+        }
+
+        Delimiters::set_kernel(previous);
+        state.set_bytes_processed(text.size());
+    }
+
+    /**
+     * @brief Registers tokenization of every translation of the_egg by every supported kernel.
+     */
+    bool register_kernel_benchmarks()
+    {
+        const std::pair<Delimiters::Kernel, std::string> kernels[] = {
+            {Delimiters::Kernel::SCALAR, "scalar"},
+            {Delimiters::Kernel::SSE2, "sse2"},
+            {Delimiters::Kernel::AVX2, "avx2"}};
+
+        for (std::string language : {"english", "czech", "spanish"})
+        {
+            for (const auto &kernel : kernels)
+            {
+                if (Delimiters::is_supported(kernel.first))
+                {
+                    Bench::register_benchmark("tokenize/kernel/" + kernel.second + "/" + language, [language, kernel](Bench::State &state) {
+                        tokenize_language(state, language, kernel.first);
+                    },
+                                              0);
+                }
+            }
+        }
+
+        return true;
+    }
+
+    void ingest_wide_stream(Bench::State &state)
+    {
+        for (auto _ : state)
+        {
+            // Original ingestion, the file is converted into a wide string one character at a time
+            std::ifstream f(state.get_corpus().file_path);
+            std::wbuffer_convert<std::codecvt_utf8<wchar_t>> conv(f.rdbuf());
+            std::wistream wf(&conv);
+
+            std::wstring file_content;
+            for (wchar_t c; wf.get(c);)
+            {
+                file_content += c;
+            }
+
+            Bench::do_not_optimize(file_content);
+        }
+
+        state.set_bytes_processed(state.get_corpus().text.size());
+    }
+
+    void ingest_read(Bench::State &state)
+    {
+        for (auto _ : state)
+        {
+            std::ifstream f(state.get_corpus().file_path, std::ios::binary);
+            std::string file_content((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+            Bench::do_not_optimize(count_words(file_content.data(), file_content.size()));
+        }
+
+        state.set_bytes_processed(state.get_corpus().text.size());
+    }
+
+    void ingest_mapped(Bench::State &state)
+    {
+        for (auto _ : state)
+        {
+            MappedFile file(state.get_corpus().file_path);
+            Bench::do_not_optimize(count_words(file.data(), file.size()));
+        }
+
+        state.set_bytes_processed(state.get_corpus().text.size());
+    }
+}; // namespace
+
+BENCHMARK_LIMITED("tokenize/regex", tokenize_regex, 16);
+BENCHMARK("tokenize/wide_words", tokenize_wide_words);
+BENCHMARK("tokenize/spans", tokenize_spans);
+static const bool kernels_registered = register_kernel_benchmarks();
+BENCHMARK_LIMITED("ingest/wide_stream", ingest_wide_stream, 256);
+BENCHMARK("ingest/read_and_tokenize", ingest_read);
+BENCHMARK("ingest/mmap_and_tokenize", ingest_mapped);
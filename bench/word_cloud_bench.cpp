@@ -0,0 +1,57 @@
+#include "bench.hpp"
+#include "../src/statistics.hpp"
+#include "../src/word_cloud.hpp"
+
+namespace
+{
+    void word_cloud_get_weighted_words(Bench::State &state)
+    {
+        Statistics stat(state.get_corpus().file_path, false);
+        stat.load();
+
+        for (auto _ : state)
+        {
+            Bench::do_not_optimize(get_weighted_words(stat.get_word_frequencies(), stat.get_symbols()));
+        }
+
+        state.set_bytes_processed(state.get_corpus().text.size());
+    }
+
+    void word_cloud_generate_text(Bench::State &state)
+    {
+        Statistics stat(state.get_corpus().file_path, false);
+        stat.load();
+        auto weighted_words = get_weighted_words(stat.get_word_frequencies(), stat.get_symbols());
+
+        for (auto _ : state)
+        {
+            Bench::do_not_optimize(generate_text(weighted_words, 0));
+        }
+
+        state.set_bytes_processed(state.get_corpus().text.size());
+    }
+
+    void word_cloud_generate_text_all_words(Bench::State &state)
+    {
+        Statistics stat(state.get_corpus().file_path, false);
+        stat.load();
+        auto weighted_words = get_weighted_words(stat.get_word_frequencies(), stat.get_symbols());
+
+        // Equal weights place every distinct word into the cloud
+        for (auto &weighted_word : weighted_words)
+        {
+            weighted_word.second = 1;
+        }
+
+        for (auto _ : state)
+        {
+            Bench::do_not_optimize(generate_text(weighted_words, 0).size());
+        }
+
+        state.set_bytes_processed(state.get_corpus().text.size());
+    }
+}; // namespace
+
+BENCHMARK("word_cloud/get_weighted_words", word_cloud_get_weighted_words);
+BENCHMARK("word_cloud/generate_text", word_cloud_generate_text);
+BENCHMARK("word_cloud/generate_text_all_words", word_cloud_generate_text_all_words);
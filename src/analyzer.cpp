@@ -1,75 +1,503 @@
 #include "analyzer.hpp"
+#include "bounded_queue.hpp"
+#include "file_reader.hpp"
 #include "word_cloud.hpp"
 
 #include <filesystem>
 #include <iostream>
+#include <mutex>
 #include <stack>
+#include <thread>
+#include <unordered_map>
 #include <regex>
 
 namespace fs = std::filesystem;
 
+namespace
+{
+    // Marks files which have to be parsed again
+    const std::size_t NOT_CACHED = SIZE_MAX;
+
+    // Found files waiting for a reader, paths are small so many of them can wait
+    const std::size_t QUEUED_PATHS = 1024;
+
+    // Read files waiting for a tokenizer, together with the limits of FileReader this caps the memory of the pipeline
+    const std::size_t PREFETCHED_FILES = 64;
+
+    // Readers mostly wait for the disk, several of them keep more requests in flight on slow and network disks
+    const unsigned int READER_THREADS = 4;
+
+    // Files read by a single batch of a reader, at most as many as fit into a ring of io_uring
+    const std::size_t READ_BATCH_SIZE = 32;
+
+    // Files whose per-file results are computed in parallel before they are passed on
+    const std::size_t REPORT_BLOCK_SIZE = 256;
+
+    // File passed from a reader to a tokenizer, content is not read for streamed and unreadable files
+    struct prefetched_file
+    {
+        Statistics *stat;
+        FileReader::file_content content;
+    };
+
+    /**
+     * @brief Compares the current state of a file with its state in the cache.
+     * @note  Touched files with equal size are hashed, their content may not have changed.
+     *
+     * @param cache     Index of the previous analysis
+     * @param file      Index of the file in the cache
+     * @param path      Path of the file
+     * @param stamp     Current stamp of the file, set only if the file is unchanged
+     *
+     * @return bool Can the file be loaded from the cache?
+     */
+    bool is_unchanged(const CorpusIndex &cache, std::size_t file, const std::string &path, CorpusIndex::file_stamp &stamp)
+    {
+        std::error_code error;
+        CorpusIndex::file_stamp cached = cache.get_file_stamp(file);
+
+        std::uint64_t size = fs::file_size(path, error);
+        if (error || size != cached.size)
+        {
+            return false;
+        }
+
+        std::int64_t modified = fs::last_write_time(path, error).time_since_epoch().count();
+        if (error)
+        {
+            return false;
+        }
+
+        stamp = CorpusIndex::file_stamp{size, modified, cached.content_hash};
+        if (modified == cached.modified)
+        {
+            return true;
+        }
+
+        try
+        {
+            MappedFile content(path);
+            return content.size() == size && CorpusIndex::hash_content(content.data(), content.size()) == cached.content_hash;
+        }
+        catch (const std::exception &e)
+        {
+            // Unreadable files are parsed again, which reports the error
+            return false;
+        }
+    }
+}; // namespace
+
+void Analyzer::walk_files(const std::function<bool(const std::string &)> &visit)
+{
+    if (!fs::is_directory(this->source_path) && !fs::is_regular_file(this->source_path))
+    {
+        // Not a valid path, stops loading
+        throw std::invalid_argument("Supplied path \"" + this->source_path + "\" is not a valid file or directory path!");
+    }
+
+    // Uses stack to prevent deep recursion
+    std::stack<std::string> files;
+    files.push(this->source_path);
+
+    while (!files.empty())
+    {
+        auto path = files.top();
+        files.pop();
+
+        // Handles only regular files or directories
+        // The rest of the is ignored
+        if (fs::is_directory(path))
+        {
+            // Iterates over entries in the directory
+            for (const auto &entry : fs::directory_iterator(path))
+            {
+                files.push(entry.path());
+            }
+        }
+        else if (fs::is_regular_file(path) && !visit(path))
+        {
+            return;
+        }
+    }
+}
+
+std::vector<std::string> Analyzer::find_files()
+{
+    std::vector<std::string> paths;
+
+    this->walk_files([&paths](const std::string &path) {
+        paths.push_back(path);
+        return true;
+    });
+
+    return paths;
+}
+
 void Analyzer::load()
 {
-    if (fs::is_directory(this->source_path) || fs::is_regular_file(this->source_path))
+    if (this->cache_path != "")
     {
-        // Uses stack to prevent deep recursion
-        std::stack<std::string> files;
-        files.push(this->source_path);
+        this->load_incremental(this->find_files());
+        return;
+    }
+
+    // Files flow through three stages, each stage works on other files at the same time
+    // Full queues block the stage before them, so only a bounded number of files is in flight
+    BoundedQueue<Statistics *> found(QUEUED_PATHS);
+    BoundedQueue<prefetched_file> prefetched(PREFETCHED_FILES);
+
+    // First error of the walker or a tokenizer, rethrown once every stage is stopped
+    std::mutex error_mutex;
+    std::exception_ptr error;
+
+    auto fail = [&](std::exception_ptr exception) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error)
+        {
+            error = exception;
+        }
+
+        found.close();
+        prefetched.close();
+    };
 
-        while (!files.empty())
+    // 1. Walker finds the files in the same order as find_files, so the order of statistics stays fixed
+    std::thread walker([&] {
+        try
         {
-            auto path = files.top();
-            files.pop();
+            this->walk_files([&](const std::string &path) {
+                Statistics *stat = new Statistics(path, this->filter_words, this->case_sensitive);
+
+                if (this->streaming)
+                {
+                    stat->set_streaming(this->streamed_n_gram_size);
+                }
+
+                // Statistics are owned by the analyzer as soon as they are created
+                this->stats.push_back(stat);
+                return found.push(stat);
+            });
+        }
+        catch (...)
+        {
+            fail(std::current_exception());
+        }
 
-            // Handles only regular files or directories
-            // The rest of the is ignored
-            if (fs::is_directory(path))
+        found.close();
+    });
+
+    // 2. Readers take batches of files and read them, waiting for the disk instead of the tokenizers
+    // Streamed files are read in chunks by the tokenizers themselves, so they are only passed on
+    std::vector<std::thread> readers;
+    for (unsigned int i = 0; i < READER_THREADS; ++i)
+    {
+        readers.emplace_back([&] {
+            try
             {
-                // Iterates over entries in the directory
-                for (const auto &entry : fs::directory_iterator(path))
+                FileReader reader;
+                std::vector<Statistics *> batch;
+                std::vector<std::string> paths;
+
+                while (found.pop_batch(batch, READ_BATCH_SIZE))
                 {
-                    files.push(entry.path());
+                    std::vector<FileReader::file_content> contents(batch.size());
+
+                    if (!this->streaming)
+                    {
+                        paths.clear();
+                        for (const auto &stat : batch)
+                        {
+                            paths.push_back(stat->get_file_path());
+                        }
+
+                        contents = reader.read(paths);
+                    }
+
+                    for (std::size_t file = 0; file < batch.size(); ++file)
+                    {
+                        if (!prefetched.push(prefetched_file{batch[file], std::move(contents[file])}))
+                        {
+                            return;
+                        }
+                    }
                 }
             }
-            else if (fs::is_regular_file(path))
+            catch (...)
+            {
+                fail(std::current_exception());
+            }
+        });
+    }
+
+    // 3. Every worker of the pool tokenizes and counts files until the readers are done
+    for (unsigned int i = 0; i < this->pool->size(); ++i)
+    {
+        this->pool->submit([&] {
+            prefetched_file file;
+            while (prefetched.pop(file))
             {
-                stats.push_back(new Statistics(path, this->filter, this->case_sensitive));
+                try
+                {
+                    if (file.content.is_read)
+                    {
+                        file.stat->load(file.content.view());
+                    }
+                    else
+                    {
+                        file.stat->load();
+                    }
+                }
+                catch (...)
+                {
+                    // Stops the other stages, so they do not wait for a stage which is gone
+                    fail(std::current_exception());
+                    return;
+                }
             }
+        });
+    }
+
+    walker.join();
+    for (auto &reader : readers)
+    {
+        reader.join();
+    }
+
+    prefetched.close();
+    this->pool->wait();
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+
+    // Moves words of every file into the shared symbol table
+    // Files are merged in a fixed order, so IDs do not depend on the number of threads
+    for (const auto &stat : this->stats)
+    {
+        stat->share_symbols(this->symbols);
+    }
+}
+
+void Analyzer::load_incremental(std::vector<std::string> paths)
+{
+    // The cache may lie inside of the analyzed directory, it is not a text file
+    fs::path cache_file = fs::absolute(this->cache_path).lexically_normal();
+    paths.erase(std::remove_if(paths.begin(), paths.end(), [&cache_file](const std::string &path) {
+                    fs::path file = fs::absolute(path).lexically_normal();
+                    return file == cache_file || file.string() == cache_file.string() + ".tmp";
+                }),
+                paths.end());
+
+    std::shared_ptr<const CorpusIndex> cache;
+
+    if (fs::exists(this->cache_path))
+    {
+        try
+        {
+            cache = std::make_shared<const CorpusIndex>(this->cache_path);
         }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Ignoring cache \"" << this->cache_path << "\": " << e.what() << "\n";
+        }
+    }
 
-        // Loads all of the words into memory
-        for (const auto &stat : this->stats)
+    // Words of a cache with different case sensitivity cannot be reused
+    if (cache && cache->is_case_sensitive() != this->case_sensitive)
+    {
+        cache.reset();
+    }
+
+    std::vector<std::size_t> cached(paths.size(), NOT_CACHED);
+    std::vector<CorpusIndex::file_stamp> stamps(paths.size());
+
+    if (cache)
+    {
+        cache->load_symbols(*this->symbols);
+        this->index = cache;
+
+        std::unordered_map<std::string, std::size_t> files;
+        for (std::size_t file = 0; file < cache->get_file_count(); ++file)
+        {
+            files.emplace(cache->get_file_path(file), file);
+        }
+
+        // Touched files are hashed, so each file is checked by a separate task
+        for (std::size_t i = 0; i < paths.size(); ++i)
+        {
+            auto file = files.find(paths[i]);
+            if (file == files.end())
+            {
+                continue;
+            }
+
+            this->pool->submit([&cache, &paths, &cached, &stamps, i, file = file->second] {
+                if (is_unchanged(*cache, file, paths[i], stamps[i]))
+                {
+                    cached[i] = file;
+                }
+            });
+        }
+
+        this->pool->wait();
+    }
+
+    std::vector<Statistics *> changed;
+    for (std::size_t i = 0; i < paths.size(); ++i)
+    {
+        if (cached[i] != NOT_CACHED)
+        {
+            stats.push_back(new Statistics(cache, cached[i], this->symbols, this->filter_words));
+            stats.back()->set_file_stamp(stamps[i]);
+        }
+        else
         {
-            stat->load();
+            stats.push_back(new Statistics(paths[i], this->filter_words, this->case_sensitive));
+            stats.back()->set_stamping();
+            changed.push_back(stats.back());
         }
     }
-    else
+
+    for (const auto &stat : this->stats)
     {
-        // Not a valid path, stops loading
-        throw std::invalid_argument("Supplied path \"" + this->source_path + "\" is not a valid file or directory path!");
+        this->pool->submit([stat] { stat->load(); });
+    }
+
+    this->pool->wait();
+
+    // Only new words of the changed files are added after the words of the cache
+    for (const auto &stat : changed)
+    {
+        stat->share_symbols(this->symbols);
+    }
+
+    for (const auto &stat : this->stats)
+    {
+        stat->set_filter(this->filter_words);
+    }
+
+    // Replaces the cache only once the new one is complete, the old one stays mapped until the analyzer is destroyed
+    std::string temporary_path = this->cache_path + ".tmp";
+    CorpusIndex::save(temporary_path, *this->symbols, this->stats, this->case_sensitive);
+    fs::rename(temporary_path, this->cache_path);
+}
+
+void Analyzer::load_index()
+{
+    this->index->load_symbols(*this->symbols);
+
+    for (std::size_t file = 0; file < this->index->get_file_count(); ++file)
+    {
+        stats.push_back(new Statistics(this->index, file, this->symbols, this->filter_words));
+    }
+
+    for (const auto &stat : this->stats)
+    {
+        this->pool->submit([stat] { stat->load(); });
+    }
+
+    this->pool->wait();
+
+    // Lookups index the symbol table on first use, so the filters are resolved by a single thread
+    for (const auto &stat : this->stats)
+    {
+        stat->set_filter(this->filter_words);
     }
 }
 
 Analyzer::Analyzer(std::string file_path, bool case_sensitive)
 {
-    this->filter = std::vector<std::wstring>();
+    this->symbols = std::make_shared<SymbolTable>();
+    this->filter_words = std::vector<std::wstring>();
     this->stats = std::vector<Statistics *>();
     this->source_path = file_path;
     this->case_sensitive = case_sensitive;
+    this->threads = ThreadPool::default_threads();
+    this->pool = std::make_unique<ThreadPool>(this->threads);
+    this->streaming = false;
+    this->streamed_n_gram_size = 0;
 
     this->load();
 }
 
 Analyzer::Analyzer(std::string file_path, std::vector<std::wstring> filter, bool case_sensitive)
 {
-    this->filter = filter;
+    this->symbols = std::make_shared<SymbolTable>();
+    this->filter_words = filter;
     this->stats = std::vector<Statistics *>();
     this->source_path = file_path;
     this->case_sensitive = case_sensitive;
+    this->threads = ThreadPool::default_threads();
+    this->pool = std::make_unique<ThreadPool>(this->threads);
+    this->streaming = false;
+    this->streamed_n_gram_size = 0;
 
     this->load();
 }
 
+Analyzer::Analyzer(std::string file_path, std::vector<std::wstring> filter, bool case_sensitive, unsigned int threads)
+{
+    this->symbols = std::make_shared<SymbolTable>();
+    this->filter_words = filter;
+    this->stats = std::vector<Statistics *>();
+    this->source_path = file_path;
+    this->case_sensitive = case_sensitive;
+    this->threads = (threads == 0) ? ThreadPool::default_threads() : threads;
+    this->pool = std::make_unique<ThreadPool>(this->threads);
+    this->streaming = false;
+    this->streamed_n_gram_size = 0;
+
+    this->load();
+}
+
+Analyzer::Analyzer(std::string file_path, std::vector<std::wstring> filter, bool case_sensitive, unsigned int threads, bool streaming, int n_gram_size)
+{
+    this->filter_words = filter;
+    this->symbols = std::make_shared<SymbolTable>();
+    this->stats = std::vector<Statistics *>();
+    this->source_path = file_path;
+    this->case_sensitive = case_sensitive;
+    this->threads = (threads == 0) ? ThreadPool::default_threads() : threads;
+    this->pool = std::make_unique<ThreadPool>(this->threads);
+    this->streaming = streaming;
+    this->streamed_n_gram_size = n_gram_size;
+
+    this->load();
+}
+
+Analyzer::Analyzer(std::string file_path, std::vector<std::wstring> filter, bool case_sensitive, unsigned int threads, std::string cache_path)
+{
+    this->filter_words = filter;
+    this->symbols = std::make_shared<SymbolTable>();
+    this->stats = std::vector<Statistics *>();
+    this->source_path = file_path;
+    this->case_sensitive = case_sensitive;
+    this->threads = (threads == 0) ? ThreadPool::default_threads() : threads;
+    this->pool = std::make_unique<ThreadPool>(this->threads);
+    this->streaming = false;
+    this->streamed_n_gram_size = 0;
+    this->cache_path = cache_path;
+
+    this->load();
+}
+
+Analyzer::Analyzer(std::shared_ptr<const CorpusIndex> index, std::vector<std::wstring> filter, unsigned int threads)
+{
+    this->filter_words = filter;
+    this->symbols = std::make_shared<SymbolTable>();
+    this->stats = std::vector<Statistics *>();
+    this->source_path = "";
+    this->case_sensitive = index->is_case_sensitive();
+    this->threads = (threads == 0) ? ThreadPool::default_threads() : threads;
+    this->pool = std::make_unique<ThreadPool>(this->threads);
+    this->streaming = false;
+    this->streamed_n_gram_size = 0;
+    this->index = index;
+
+    this->load_index();
+}
+
 Analyzer::~Analyzer()
 {
     for (auto stat : this->stats)
@@ -80,7 +508,8 @@ Analyzer::~Analyzer()
 
 void Analyzer::set_filters(std::vector<std::wstring> filter)
 {
-    this->filter = filter;
+    this->filter_words = filter;
+    this->clear_results();
 
     for (auto stat : this->stats)
     {
@@ -88,41 +517,50 @@ void Analyzer::set_filters(std::vector<std::wstring> filter)
     }
 }
 
-long Analyzer::get_word_count()
+void Analyzer::save_index(std::string file_path)
 {
-    long count = 0;
-
-    for (const auto &stat : this->stats)
+    if (this->streaming)
     {
-        count += stat->get_word_count();
+        throw std::invalid_argument("Index cannot be created in streaming mode, words of the files are not kept.");
     }
 
-    return count;
+    CorpusIndex::save(file_path, *this->symbols, this->stats, this->case_sensitive);
 }
 
-long Analyzer::get_unique_word_count()
+void Analyzer::clear_results()
 {
-    std::vector<std::wstring> result;
+    this->word_counts.reset();
+    this->word_count.reset();
+    this->unique_word_count.reset();
+    this->n_gram_tables.clear();
+}
 
-    for (const auto &stat : this->stats)
+long Analyzer::get_word_count()
+{
+    if (!this->word_count)
     {
-        auto words = stat->get_words();
+        long count = 0;
 
-        for (const auto &word : words)
+        for (const auto &stat : this->stats)
         {
-            // Temporary variables used to remove long line
-            // And to enhance readibility
-            bool is_not_duplicate = std::find(result.begin(), result.end(), word) == result.end();
-            bool is_not_filtered = std::find(this->filter.begin(), this->filter.end(), word) == this->filter.end();
-
-            if (is_not_duplicate && is_not_filtered)
-            {
-                result.push_back(word);
-            }
+            count += stat->get_word_count();
         }
+
+        this->word_count = count;
+    }
+
+    return *this->word_count;
+}
+
+long Analyzer::get_unique_word_count()
+{
+    if (!this->unique_word_count)
+    {
+        // Merged table holds every distinct word which is not filtered out exactly once
+        this->unique_word_count = this->count_words().get_counts().size();
     }
 
-    return result.size();
+    return *this->unique_word_count;
 }
 
 std::vector<std::pair<std::string, long>> Analyzer::get_word_count_per_file()
@@ -161,21 +599,63 @@ std::vector<std::pair<std::string, long>> Analyzer::get_unique_word_count_per_fi
     return pairs;
 }
 
-std::vector<std::wstring> Analyzer::get_words()
+const WordCountTable &Analyzer::count_words()
 {
-    std::vector<std::wstring> result;
+    if (this->word_counts)
+    {
+        return *this->word_counts;
+    }
+
+    if (this->stats.empty())
+    {
+        return this->word_counts.emplace();
+    }
+
+    std::vector<WordCountTable> tables;
+    tables.reserve(this->stats.size());
 
     for (const auto &stat : this->stats)
     {
-        std::vector<std::wstring> words = stat->get_words();
-        result.reserve(result.size() + words.size());
-        result.insert(result.end(), words.begin(), words.end());
+        // Filtered words were already left out of the tables of the files
+        tables.push_back(stat->get_filtered_frequencies());
     }
 
-    return result;
+    return this->word_counts.emplace(this->pool->reduce(std::move(tables), [](WordCountTable &target, WordCountTable &source) {
+        target.merge(source);
+    }));
 }
 
-std::vector<Statistics::n_gram> Analyzer::generate_n_gram(int size)
+const NGramTable &Analyzer::count_n_grams(int size)
+{
+    auto found = this->n_gram_tables.find(size);
+    if (found != this->n_gram_tables.end())
+    {
+        return found->second;
+    }
+
+    if (this->stats.empty())
+    {
+        return this->n_gram_tables.emplace(size, NGramTable(size)).first->second;
+    }
+
+    // Counts n-grams of each file in parallel
+    std::vector<NGramTable> tables(this->stats.size(), NGramTable(size));
+    for (std::size_t i = 0; i < this->stats.size(); ++i)
+    {
+        this->pool->submit([this, &tables, i, size] { tables[i] = this->stats[i]->count_n_grams(size); });
+    }
+
+    this->pool->wait();
+
+    // Counts of every file are merged by hash of their word IDs
+    NGramTable grams = this->pool->reduce(std::move(tables), [](NGramTable &target, NGramTable &source) {
+        target.merge(source);
+    });
+
+    return this->n_gram_tables.emplace(size, std::move(grams)).first->second;
+}
+
+std::vector<Statistics::n_gram> Analyzer::generate_n_gram(int size, std::size_t count)
 {
 
     // N-grams must be at least 1 word long
@@ -184,44 +664,30 @@ std::vector<Statistics::n_gram> Analyzer::generate_n_gram(int size)
         throw std::invalid_argument("N-gram size was too small!");
     }
 
-    std::vector<Statistics::n_gram> sorter;
+    const NGramTable &grams = this->count_n_grams(size);
 
-    for (const auto &stat : stats)
+    // Converts only the most frequent n-grams into text
+    std::vector<Statistics::n_gram> result;
+    for (auto index : grams.get_most_frequent(count, *this->symbols))
     {
-        for (auto gram : stat->get_n_grams(size))
-        {
-            // Tries to find if n-gram is already present
-            auto cur_value = std::find_if(sorter.begin(), sorter.end(),
-                                          [gram](const Statistics::n_gram &comp) { return gram.value == comp.value; });
-
-            // If not present, creates a new n-gram with new values
-            // Values calculated by Statistics are then not kept
-            // If present, values are just added together
-            if (cur_value == sorter.end())
-            {
-                sorter.push_back(Statistics::n_gram{gram.value, gram.count});
-            }
-            else
-            {
-                cur_value->count += gram.count;
-            }
-        }
+        result.push_back(Statistics::n_gram{grams.get_text(index, *this->symbols), grams.get_count(index)});
     }
 
-    // Sorts the vector by counts of n-gram occurences in descending order
-    std::sort(sorter.begin(), sorter.end(),
-              [](const Statistics::n_gram &a, const Statistics::n_gram &b) {
-                  return a.count > b.count;
-              });
+    return result;
+}
 
-    // Creates a subvector from the five most frequent n-grams
-    std::vector<Statistics::n_gram> result;
-    std::copy(sorter.begin(), sorter.begin() + 5, std::back_inserter(result));
+std::vector<std::pair<std::string, std::vector<Statistics::n_gram>>> Analyzer::generate_n_gram_per_file(int size, std::size_t count)
+{
+    std::vector<std::pair<std::string, std::vector<Statistics::n_gram>>> result;
+
+    this->generate_n_gram_per_file(size, count, [&result](const std::string &file_path, const std::vector<Statistics::n_gram> &n_grams) {
+        result.push_back(std::make_pair(file_path, n_grams));
+    });
 
     return result;
 }
 
-std::vector<std::pair<std::string, std::vector<Statistics::n_gram>>> Analyzer::generate_n_gram_per_file(int size)
+void Analyzer::generate_n_gram_per_file(int size, std::size_t count, const std::function<void(const std::string &, const std::vector<Statistics::n_gram> &)> &output)
 {
     // N-grams must be at least 1 word long
     if (size < 1)
@@ -229,36 +695,53 @@ std::vector<std::pair<std::string, std::vector<Statistics::n_gram>>> Analyzer::g
         throw std::invalid_argument("N-gram size was too small!");
     }
 
-    std::vector<std::pair<std::string, std::vector<Statistics::n_gram>>> result;
+    // Sorts files by their paths, only the order is sorted so no results have to be moved
+    std::vector<std::pair<std::string, Statistics *>> files;
+    files.reserve(this->stats.size());
 
-    for (const auto &stat : stats)
+    for (const auto &stat : this->stats)
     {
-        // Gets file n-grams and picks the 5 most frequent
-        auto original = stat->get_n_grams(size);
-        std::vector<Statistics::n_gram> stat_grams;
-        std::copy(original.begin(), original.begin() + 5, std::back_inserter(stat_grams));
-
-        result.push_back(std::make_pair(stat->get_file_path(), stat_grams));
+        files.push_back(std::make_pair(stat->get_file_path(), stat));
     }
 
-    // Sorts n-grams by file name
-    std::sort(result.begin(), result.end(),
-              [](const std::pair<std::string, std::vector<Statistics::n_gram>> &a,
-                 const std::pair<std::string, std::vector<Statistics::n_gram>> &b) {
+    std::sort(files.begin(), files.end(),
+              [](const std::pair<std::string, Statistics *> &a, const std::pair<std::string, Statistics *> &b) {
                   return a.first < b.first;
               });
 
-    return result;
+    std::vector<std::vector<Statistics::n_gram>> block;
+
+    for (std::size_t start = 0; start < files.size(); start += REPORT_BLOCK_SIZE)
+    {
+        std::size_t length = std::min(REPORT_BLOCK_SIZE, files.size() - start);
+        block.assign(length, std::vector<Statistics::n_gram>());
+
+        // Files are independent, each of them is processed by a separate task
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            this->pool->submit([&block, &files, start, i, size, count] {
+                // Gets the most frequent file n-grams, the table of the file is dropped right after
+                block[i] = files[start + i].second->find_n_grams(size, count);
+            });
+        }
+
+        this->pool->wait();
+
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            output(files[start + i].first, block[i]);
+        }
+    }
 }
 
-void Analyzer::generate_word_cloud(std::string target_path)
+void Analyzer::generate_word_cloud(std::string target_path, unsigned int seed)
 {
     std::string file_path = (target_path == "") ? "word_cloud.svg" : target_path + ".svg";
 
-    create_word_cloud(get_words(), file_path);
+    create_word_cloud(this->count_words(), *this->symbols, seed, file_path);
 }
 
-void Analyzer::generate_word_cloud_per_file(std::string directory_path)
+void Analyzer::generate_word_cloud_per_file(std::string directory_path, unsigned int seed)
 {
     try
     {
@@ -269,6 +752,7 @@ void Analyzer::generate_word_cloud_per_file(std::string directory_path)
             fs::create_directory(directory);
         }
 
+        // Every cloud is rendered and written by a separate task
         for (const auto &stat : stats)
         {
             std::string file_name = stat->get_file_path();
@@ -292,8 +776,12 @@ void Analyzer::generate_word_cloud_per_file(std::string directory_path)
             fs::path full_path(directory);
             full_path /= file_name;
 
-            create_word_cloud(stat->get_words(), full_path);
+            this->pool->submit([this, stat, seed, full_path] {
+                create_word_cloud(stat->get_filtered_frequencies(), *this->symbols, seed, full_path.string());
+            });
         }
+
+        this->pool->wait();
     }
     catch (const std::exception &e)
     {
@@ -1,6 +1,13 @@
+#include "corpus_index.hpp"
 #include "statistics.hpp"
+#include "symbol_table.hpp"
+#include "thread_pool.hpp"
 #include "word_cloud.hpp"
 
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
 #include <vector>
 #include <string>
 #include <map>
@@ -14,13 +21,36 @@ private:
     // List of pointers to Statistics for each file
     std::vector<Statistics *> stats;
 
-    // List of filtered out words
-    std::vector<std::wstring> filter;
+    // Table of every distinct word in all of the files, shared with Statistics
+    std::shared_ptr<SymbolTable> symbols;
+
+    // Filtered out words, every Statistics resolves and applies them to its own words
+    std::vector<std::wstring> filter_words;
 
     std::string source_path;
 
     bool case_sensitive;
 
+    // Number of threads used to load the files and to combine their results
+    unsigned int threads;
+    std::unique_ptr<ThreadPool> pool;
+
+    // Are files read in chunks, keeping only counts?
+    bool streaming;
+    int streamed_n_gram_size;
+
+    // Index the files are loaded from instead of parsing them, if set
+    std::shared_ptr<const CorpusIndex> index;
+
+    // Index of the previous analysis, only changed files are parsed again if set
+    std::string cache_path;
+
+    // Corpus-wide results are computed on the first request and kept until the filter changes
+    std::optional<WordCountTable> word_counts;
+    std::optional<long> word_count;
+    std::optional<long> unique_word_count;
+    std::map<int, NGramTable> n_gram_tables;
+
 public:
     /**
      * @brief  Constructs ::wstring over either a path to a file or a path to a directory.
@@ -41,15 +71,75 @@ public:
      */
     Analyzer(std::string path, std::vector<std::wstring> filter, bool case_sensitive);
 
+    /**
+     * @brief  Constructs ::wstring over either a path to a file or a path to a directory.
+     * @note   Only text files are supported. Directories are searched recursively.
+     * 
+     * @param  path             Path to a file or a directory
+     * @param  filter           Words to be filtered out of the analysis
+     * @param  case_sensitive   Should case be ignored?
+     * @param  threads          Number of threads loading the files, 0 uses every hardware thread
+     */
+    Analyzer(std::string path, std::vector<std::wstring> filter, bool case_sensitive, unsigned int threads);
+
+    /**
+     * @brief  Constructs ::wstring over either a path to a file or a path to a directory.
+     * @note   Only text files are supported. Directories are searched recursively.
+     * @note   In streaming mode files are read in chunks and only counts are kept in memory.
+     * Only n-grams of the set size can be generated and word clouds are not available.
+     * 
+     * @param  path             Path to a file or a directory
+     * @param  filter           Words to be filtered out of the analysis
+     * @param  case_sensitive   Should case be ignored?
+     * @param  threads          Number of threads loading the files, 0 uses every hardware thread
+     * @param  streaming        Should files be read in chunks?
+     * @param  n_gram_size      Size of n-grams counted in streaming mode, no n-grams are counted if less than 1
+     */
+    Analyzer(std::string path, std::vector<std::wstring> filter, bool case_sensitive, unsigned int threads, bool streaming, int n_gram_size);
+
+    /**
+     * @brief  Constructs ::wstring over either a path to a file or a path to a directory, reusing a previous analysis.
+     * @note   Files with the same size and modification time or content as in the cache are loaded from it,
+     * only new and changed files are tokenized. Deleted files are dropped. The cache is rewritten afterwards.
+     * A missing, invalid or differently cased cache is ignored.
+     * 
+     * @param  path             Path to a file or a directory
+     * @param  filter           Words to be filtered out of the analysis
+     * @param  case_sensitive   Should case be ignored?
+     * @param  threads          Number of threads loading the files, 0 uses every hardware thread
+     * @param  cache_path       Path of the index holding the previous analysis, created if missing
+     */
+    Analyzer(std::string path, std::vector<std::wstring> filter, bool case_sensitive, unsigned int threads, std::string cache_path);
+
+    /**
+     * @brief  Constructs ::wstring over files stored in an index.
+     * @note   Words are used in place from the memory mapped index, files are not read or tokenized again.
+     * Case sensitivity is the same as when the index was created.
+     * 
+     * @param  index    Loaded index
+     * @param  filter   Words to be filtered out of the analysis
+     * @param  threads  Number of threads combining the results, 0 uses every hardware thread
+     */
+    Analyzer(std::shared_ptr<const CorpusIndex> index, std::vector<std::wstring> filter, unsigned int threads);
+
     ~Analyzer();
 
     /**
      * @brief  Sets the list of filtered out words.
+     * @note   Results computed for the previous filter are dropped.
      * 
      * @param  filter   Vector of words to be filtered out
      */
     void set_filters(std::vector<std::wstring> filter);
 
+    /**
+     * @brief  Saves the symbol table, words and word counts of every file into an index.
+     * @note   Throws in streaming mode, words of the files are not kept.
+     * 
+     * @param  file_path    Path of the index
+     */
+    void save_index(std::string file_path);
+
     /**
      * @brief  Counts every word loaded from path.
      * @note   Discards filtered out words.
@@ -81,51 +171,119 @@ public:
     std::vector<std::pair<std::string, long>> get_unique_word_count_per_file();
 
     /**
-     * @brief  Generates five most frequent n-grams.
+     * @brief  Generates the most frequent n-grams.
      * @note   Discards filtered out words. Throws if set word is filtered out.
      * 
-     * @param  size Size of the n-gram (n)
+     * @param  size     Size of the n-gram (n)
+     * @param  count    Number of generated n-grams (k)
      * 
      * @retval Vector of n_grams
      */
-    std::vector<Statistics::n_gram> generate_n_gram(int size);
+    std::vector<Statistics::n_gram> generate_n_gram(int size, std::size_t count);
 
     /**
-     * @brief  Generates five most frequent n-grams per file.
+     * @brief  Generates the most frequent n-grams per file.
      * @note   Discards filtered out words. Throws if set word is filtered out.
      * 
-     * @param  size Size of the n-gram (n)
+     * @param  size     Size of the n-gram (n)
+     * @param  count    Number of generated n-grams per file (k)
      * 
      * @retval Vector of pairs with file path as first and vector of n_grams as second
      */
-    std::vector<std::pair<std::string, std::vector<Statistics::n_gram>>> generate_n_gram_per_file(int size);
+    std::vector<std::pair<std::string, std::vector<Statistics::n_gram>>> generate_n_gram_per_file(int size, std::size_t count);
+
+    /**
+     * @brief  Generates the most frequent n-grams per file and passes them on as soon as they are ready.
+     * @note   Discards filtered out words. Files are passed on in order of their paths.
+     * @note   Files are processed in parallel in blocks, only the n-grams of a single block are kept at once.
+     * N-gram tables of the files are dropped as soon as their most frequent n-grams are selected.
+     * 
+     * @param  size     Size of the n-gram (n)
+     * @param  count    Number of generated n-grams per file (k)
+     * @param  output   Receives the file path and the n-grams of every file
+     */
+    void generate_n_gram_per_file(int size, std::size_t count, const std::function<void(const std::string &, const std::vector<Statistics::n_gram> &)> &output);
 
     /**
      * @brief  Generates a word cloud.
      * @note   Discards filtered out words.
      * 
      * @param target_path   Name of the output svg file
+     * @param seed          Seed of the layout, equal seeds produce equal clouds
      */
-    void generate_word_cloud(std::string target_path);
+    void generate_word_cloud(std::string target_path, unsigned int seed);
 
     /**
      * @brief  Generates a word clouds per file.
      * @note   Discards filtered out words.
+     * @note   Clouds are rendered and written in parallel on the thread pool.
      * 
      * @param directory_path    Name of the directory where output svg files will be written
+     * @param seed              Seed of the layout, equal seeds produce equal clouds
      */
-    void generate_word_cloud_per_file(std::string directory_path);
+    void generate_word_cloud_per_file(std::string directory_path, unsigned int seed);
 
 private:
     /**
-     * @brief Returns all of the words loaded by the analyzer.
+     * @brief  Merges word counts of every file into a single table.
+     * @note   Filtered out words are left out of the tables of the files before they are merged.
+     * @note   Tables are combined by a parallel tree reduction. The table is merged once and kept.
+     * 
+     * @retval Counts of every word in all of the files
+     */
+    const WordCountTable &count_words();
+
+    /**
+     * @brief  Counts n-grams of every file in parallel and merges them into a single table.
+     * @note   Tables are combined by a parallel tree reduction. Table of each size is merged once and kept.
+     * 
+     * @param  size Size of the n-gram (n)
+     * 
+     * @retval Counts of every n-gram in all of the files
+     */
+    const NGramTable &count_n_grams(int size);
+
+    /**
+     * @brief  Drops every kept result, they are computed again on the next request.
+     */
+    void clear_results();
+
+    /**
+     * @brief  Walks the source path and calls a function for every regular file found.
+     * @note   Throws if the source path is not a valid file or directory path.
      * 
-     * @retval Vector of words in all of the files
+     * @param  visit    Called with the path of every file, the walk stops once it returns false
      */
-    std::vector<std::wstring> get_words();
+    void walk_files(const std::function<bool(const std::string &)> &visit);
+
+    /**
+     * @brief  Finds every regular file of the source path.
+     * @note   Throws if the source path is not a valid file or directory path.
+     * 
+     * @retval Paths of the files
+     */
+    std::vector<std::string> find_files();
 
     /**
      * @brief  Loads the file statistics.
+     * @note   Files pass through a pipeline of three stages running at the same time. A walker finds the files,
+     * readers map and prefetch them and workers of the thread pool tokenize them. Stages are connected by bounded
+     * queues, so only the paths and the read content in flight are bounded. Words and counts of every loaded file
+     * are kept, so the memory of the loaded statistics still grows with the corpus.
+     * The order of statistics does not depend on the number of threads.
      */
     void load();
+
+    /**
+     * @brief  Loads unchanged files from the cache and parses the rest, then rewrites the cache.
+     * 
+     * @param  paths    Paths of the files
+     */
+    void load_incremental(std::vector<std::string> paths);
+
+    /**
+     * @brief  Loads the file statistics from the index.
+     * @note   Only word counts are read, word IDs stay in the mapped index.
+     */
+    void load_index();
 };
\ No newline at end of file
@@ -0,0 +1,51 @@
+#include "arena.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    // Chunks stop growing at this size, larger chunks would mostly stay empty
+    const std::size_t MAX_CHUNK_SIZE = 1 << 20;
+}; // namespace
+
+Arena::Arena(std::size_t first_chunk_size) : chunk_size(std::max<std::size_t>(first_chunk_size, 1))
+{
+}
+
+std::string_view Arena::store(std::string_view bytes)
+{
+    if (bytes.size() > this->remaining)
+    {
+        this->add_chunk(bytes.size());
+    }
+
+    char *stored = this->current;
+    if (!bytes.empty())
+    {
+        std::memcpy(stored, bytes.data(), bytes.size());
+    }
+
+    this->current += bytes.size();
+    this->remaining -= bytes.size();
+    this->used += bytes.size();
+
+    return std::string_view(stored, bytes.size());
+}
+
+std::size_t Arena::size() const
+{
+    return this->used;
+}
+
+void Arena::add_chunk(std::size_t minimum)
+{
+    // Rest of the previous chunk is left unused, it is smaller than the bytes being stored
+    std::size_t size = std::max(this->chunk_size, minimum);
+    this->chunk_size = std::min(this->chunk_size * 2, MAX_CHUNK_SIZE);
+
+    // Bytes are always written before they are read, so the chunk is not zeroed
+    this->chunks.push_back(std::unique_ptr<char[]>(new char[size]));
+    this->current = this->chunks.back().get();
+    this->remaining = size;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Bump allocator storing bytes back to back in large chunks.
+ * @note  Stored bytes are never freed one by one, every chunk is released at once when the arena is destroyed.
+ * Bytes never move, so views of them stay valid for the whole lifetime of the arena.
+ */
+class Arena
+{
+private:
+    // Chunks of memory, only the last one is being filled
+    std::vector<std::unique_ptr<char[]>> chunks;
+    char *current = nullptr;
+    std::size_t remaining = 0;
+
+    // Size of the next chunk, doubled with every chunk up to a limit
+    std::size_t chunk_size;
+
+    // Number of stored bytes
+    std::size_t used = 0;
+
+public:
+    /**
+     * @brief Creates an empty arena, no memory is allocated until the first bytes are stored.
+     *
+     * @param first_chunk_size Size of the first chunk in bytes
+     */
+    explicit Arena(std::size_t first_chunk_size = 4096);
+
+    // Views of the stored bytes point into the chunks, which have a single owner
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    Arena(Arena &&) = default;
+    Arena &operator=(Arena &&) = default;
+
+    /**
+     * @brief Copies bytes into the arena.
+     *
+     * @param bytes Bytes to be stored
+     *
+     * @return std::string_view View of the stored copy
+     */
+    std::string_view store(std::string_view bytes);
+
+    /**
+     * @brief Returns the number of stored bytes.
+     *
+     * @return std::size_t Number of bytes
+     */
+    std::size_t size() const;
+
+private:
+    /**
+     * @brief Allocates a new chunk with room for at least the number of bytes.
+     */
+    void add_chunk(std::size_t minimum);
+};
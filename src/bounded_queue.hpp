@@ -0,0 +1,131 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Queue of limited capacity connecting stages of a pipeline.
+ * @note  Producers block while the queue is full, so a fast stage cannot run ahead of a slow one
+ * and the number of items in flight never exceeds the capacity.
+ */
+template <typename T>
+class BoundedQueue
+{
+private:
+    std::mutex mutex;
+    std::condition_variable not_full;
+    std::condition_variable not_empty;
+
+    std::deque<T> items;
+    std::size_t capacity;
+
+    // Closed queue accepts no more items, consumers still take the remaining ones
+    bool closed = false;
+
+public:
+    /**
+     * @brief Creates an empty queue.
+     *
+     * @param capacity Maximum number of items in the queue, at least 1
+     */
+    explicit BoundedQueue(std::size_t capacity) : capacity(capacity > 0 ? capacity : 1) {}
+
+    BoundedQueue(const BoundedQueue &) = delete;
+    BoundedQueue &operator=(const BoundedQueue &) = delete;
+
+    /**
+     * @brief Adds an item, waiting until there is room for it.
+     *
+     * @param item Item to be added
+     *
+     * @return bool Was the item added? False if the queue was closed
+     */
+    bool push(T item)
+    {
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->not_full.wait(lock, [this] { return this->items.size() < this->capacity || this->closed; });
+
+            if (this->closed)
+            {
+                return false;
+            }
+
+            this->items.push_back(std::move(item));
+        }
+
+        this->not_empty.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Takes the oldest item, waiting until there is one.
+     *
+     * @param item Taken item
+     *
+     * @return bool Was an item taken? False once the queue is closed and empty
+     */
+    bool pop(T &item)
+    {
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->not_empty.wait(lock, [this] { return !this->items.empty() || this->closed; });
+
+            if (this->items.empty())
+            {
+                return false;
+            }
+
+            item = std::move(this->items.front());
+            this->items.pop_front();
+        }
+
+        this->not_full.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Takes up to a number of the oldest items, waiting until there is at least one.
+     * @note  Lets a consumer work on items in batches without waiting for a full batch.
+     *
+     * @param batch Taken items, replaces its content
+     * @param limit Maximum number of taken items
+     *
+     * @return bool Were any items taken? False once the queue is closed and empty
+     */
+    bool pop_batch(std::vector<T> &batch, std::size_t limit)
+    {
+        batch.clear();
+
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->not_empty.wait(lock, [this] { return !this->items.empty() || this->closed; });
+
+            while (!this->items.empty() && batch.size() < limit)
+            {
+                batch.push_back(std::move(this->items.front()));
+                this->items.pop_front();
+            }
+        }
+
+        this->not_full.notify_all();
+        return !batch.empty();
+    }
+
+    /**
+     * @brief Closes the queue, waking every waiting producer and consumer.
+     */
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->closed = true;
+        }
+
+        this->not_full.notify_all();
+        this->not_empty.notify_all();
+    }
+};
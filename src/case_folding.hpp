@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace CaseFolding
+{
+    /**
+     * @brief Folds a code point by the Unicode simple case folding.
+     * @note  Looks the code point up in compact tables of blocks, code points without a mapping are returned unchanged.
+     *
+     * @param code_point Unicode code point
+     *
+     * @return char32_t Folded code point
+     */
+    char32_t fold(char32_t code_point);
+
+    /**
+     * @brief Folds every character of a UTF-8 encoded word, so words differing only in case become equal.
+     * @note  ASCII characters are folded without any lookup. Words which do not change are not copied.
+     * Invalid sequences are kept as they are.
+     *
+     * @param word      UTF-8 encoded word
+     * @param buffer    Buffer for the folded word, reused to avoid an allocation per word
+     *
+     * @return std::string_view Folded word, either the word itself or a view of the buffer
+     */
+    std::string_view fold(std::string_view word, std::string &buffer);
+}; // namespace CaseFolding
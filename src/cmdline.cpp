@@ -1,8 +1,11 @@
 #include "cmdline.hpp"
+#include "stop_words.hpp"
 
+#include <filesystem>
 #include <regex>
 #include <fstream>
 #include <iostream>
+#include <unordered_set>
 
 namespace fs = std::filesystem;
 
@@ -15,6 +18,7 @@ std::vector<std::wstring> CommandLine::parse_word_filter(std::string words)
         // Converting to wstring due to the rest of the code working with wstring
         std::wstring wide_words(words.begin(), words.end());
         std::wregex delimiter(L"[^\\s,]+");
+        std::unordered_set<std::wstring> found;
 
         // Ugly long line, that's why for is separated into three lines to keep it readable
         for (std::wsregex_iterator i = std::wsregex_iterator(wide_words.begin(), wide_words.end(), delimiter);
@@ -22,7 +26,7 @@ std::vector<std::wstring> CommandLine::parse_word_filter(std::string words)
              ++i)
         {
             // Only adds a non-duplicate
-            if (std::find(result.begin(), result.end(), (*i).str()) == result.end())
+            if (found.insert((*i).str()).second)
             {
                 result.push_back((*i).str());
             }
@@ -103,6 +107,10 @@ CommandLine::CommandLineOptions CommandLine::parse_command_line(int argc, char *
         {
             options.ignore_case = true;
         }
+        else if (arg == "-s" || arg == "--stream")
+        {
+            options.streaming = true;
+        }
         else if ((arg == "-t" || arg == "--target") && i + 1 < argc)
         {
             options.target_path = argv[i + 1];
@@ -113,6 +121,58 @@ CommandLine::CommandLineOptions CommandLine::parse_command_line(int argc, char *
             options.n_gram_size = std::stoi(argv[i + 1]);
             i += 1;
         }
+        else if ((arg == "-k" || arg == "--top") && i + 1 < argc)
+        {
+            options.n_gram_count = std::stoi(argv[i + 1]);
+
+            if (options.n_gram_count < 1)
+            {
+                throw std::invalid_argument("Number of n-grams must be at least 1.");
+            }
+
+            i += 1;
+        }
+        else if ((arg == "-x" || arg == "--index") && i + 1 < argc)
+        {
+            options.index_path = argv[i + 1];
+            i += 1;
+        }
+        else if (arg == "-fx" || arg == "--from-index")
+        {
+            options.from_index = true;
+        }
+        else if ((arg == "-ic" || arg == "--incremental") && i + 1 < argc)
+        {
+            options.cache_path = argv[i + 1];
+            i += 1;
+        }
+        else if ((arg == "-rd" || arg == "--reader") && i + 1 < argc)
+        {
+            options.reader = argv[i + 1];
+            i += 1;
+        }
+        else if ((arg == "-fm" || arg == "--format") && i + 1 < argc)
+        {
+            options.format = argv[i + 1];
+            i += 1;
+        }
+        else if ((arg == "-r" || arg == "--seed") && i + 1 < argc)
+        {
+            options.seed = static_cast<unsigned int>(std::stoul(argv[i + 1]));
+            i += 1;
+        }
+        else if ((arg == "-j" || arg == "--threads") && i + 1 < argc)
+        {
+            int threads = std::stoi(argv[i + 1]);
+
+            if (threads < 1)
+            {
+                throw std::invalid_argument("Number of threads must be at least 1.");
+            }
+
+            options.threads = threads;
+            i += 1;
+        }
         else if ((arg == "-f" || arg == "--filter") && i + 1 < argc)
         {
             options.filtered_words = CommandLine::parse_word_filter(std::string(argv[i + 1]));
@@ -123,12 +183,24 @@ CommandLine::CommandLineOptions CommandLine::parse_command_line(int argc, char *
             options.filtered_words = CommandLine::parse_file_filter(std::string(argv[i + 1]));
             i += 1;
         }
+        else if ((arg == "-sw" || arg == "--stopWords") && i + 1 < argc)
+        {
+            options.stop_words = argv[i + 1];
+            i += 1;
+        }
         else if (i > 1)
         {
             throw std::invalid_argument("Unknown argument \"" + arg + "\"");
         }
     }
 
+    // Built-in stop words are added to words filtered by the other options
+    if (options.stop_words != "")
+    {
+        std::vector<std::wstring> stop_words = StopWords::get(options.stop_words);
+        options.filtered_words.insert(options.filtered_words.end(), stop_words.begin(), stop_words.end());
+    }
+
     return options;
 }
 
@@ -139,13 +211,23 @@ void CommandLine::show_help()
               << "\t-h,--help\t\t\tShow this help message\n"
               << "\t-p,--perFile\t\t\tGenerate report per file. Off by default\n"
               << "\t-i,--ignoreCase\t\t\tIgnore case sensitivity. False by default\n"
+              << "\t-s,--stream\t\t\tReads files in chunks and keeps only counts in memory. Off by default\n"
               << "\t-t,--target /file/path\t\tGenerates report into a text file or a directory with set path (do not add filename extension). Off by default\n"
               << "\t\t\t\t\tIt may be needed to use target file for n-grams due to\n"
               << "\t\t\t\t\tinability of some terminals and compilers to display UTF-8 encoded characters.\n"
               << "\t-n,--ngrams x\t\t\tGenerates ngrams of size x. x must be 1 or higher. Off by default\n"
+              << "\t-k,--top x\t\t\tShows x most frequent n-grams. 5 by default\n"
+              << "\t-j,--threads x\t\t\tLoads files using x threads. Number of hardware threads by default\n"
               << "\t-w,--words\t\t\tTurns off printing of number of words. On by default.\n"
               << "\t-u,--unique\t\t\tTurns off printing of number of unique words. On by default\n\n"
               << "\t-f,--filter x,y,z\t\tSet of words to filter out. Must be separated by \",\". Empty by default\n"
               << "\t-ff,--fileFilter /file/path\tPath to a file with words to filter out. Each line must contain exactly one word. Empty by default\n"
-              << "\t-c, --cloud\t\t\tGenerates a word cloud image from set file(s).\n\t\t\t\t\tTarget path path is then used as a file (do not add filename extension) or directory name for the output files.\n\t\t\t\t\tNo other data is generated. Off by default.\n";
+              << "\t-sw,--stopWords language\tFilters out built-in stop words of the language. Only \"english\" is available. Off by default\n"
+              << "\t-c, --cloud\t\t\tGenerates a word cloud image from set file(s).\n\t\t\t\t\tTarget path path is then used as a file (do not add filename extension) or directory name for the output files.\n\t\t\t\t\tNo other data is generated. Off by default.\n"
+              << "\t-x,--index /file/path\t\tSaves words of the loaded files into a binary index for later analysis. Off by default\n"
+              << "\t-fx,--from-index\t\tSource path is an index created by --index, files are not read again. Off by default\n"
+              << "\t-ic,--incremental /file/path\tReuses the analysis cached at the path, only new and changed files are read. Off by default\n"
+              << "\t-rd,--reader name\t\tReads small files by \"mmap\", \"pread\" or \"io_uring\" (batched, Linux only, falls back to pread). mmap by default\n"
+              << "\t-fm,--format name\t\tWrites statistics as \"text\", \"json\" (JSON Lines), \"csv\", \"tsv\" or \"msgpack\". text by default\n"
+              << "\t-r,--seed x\t\t\tSeed of the word cloud layout. Equal seeds generate equal clouds. 0 by default\n";
 }
\ No newline at end of file
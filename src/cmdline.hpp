@@ -10,15 +10,43 @@ namespace CommandLine
 
         std::vector<std::wstring> filtered_words;
 
+        // Language of the built-in stop words added to the filtered words, none if empty
+        std::string stop_words = "";
+
         bool show_help = false;
         bool print_words = true;
         bool print_unique = true;
         bool per_file = false;
         bool ignore_case = false;
+        bool streaming = false;
 
         int n_gram_size = INT32_MIN;
 
+        // Number of the most frequent n-grams shown
+        int n_gram_count = 5;
+
+        // 0 uses every hardware thread
+        unsigned int threads = 0;
+
         bool word_cloud = false;
+
+        // Seed of the word cloud layout, equal seeds produce equal clouds
+        unsigned int seed = 0;
+
+        // Path of the created index, no index is created if empty
+        std::string index_path = "";
+
+        // Is the source path an index instead of a file or a directory?
+        bool from_index = false;
+
+        // Path of the index holding the previous analysis, files are always parsed if empty
+        std::string cache_path = "";
+
+        // Backend reading small files, one of "mmap", "pread" or "io_uring"
+        std::string reader = "mmap";
+
+        // Format of the written statistics, one of "text", "json", "csv", "tsv" or "msgpack"
+        std::string format = "text";
     };
 
     /**
@@ -0,0 +1,327 @@
+#include "corpus_index.hpp"
+#include "statistics.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+    // Identifies the file as an index and the version of its format
+    const char MAGIC[8] = {'T', 'X', 'T', 'A', 'I', 'D', 'X', '3'};
+
+    // Written in the byte order of the machine, reads back differently on machines with other byte order
+    const std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+    // Set if the words were converted to lower case
+    const std::uint32_t FLAG_CASE_SENSITIVE = 1;
+
+    // Every section starts at an offset divisible by the alignment
+    const std::uint64_t ALIGNMENT = 8;
+
+    std::uint64_t rotate_left(std::uint64_t value, int bits)
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    std::uint64_t align(std::uint64_t offset)
+    {
+        return (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    }
+
+    /**
+     * @brief Writes zeros after a section of the size, so the next section is aligned.
+     */
+    void write_padding(std::ofstream &file, std::uint64_t size)
+    {
+        static const char padding[ALIGNMENT] = {};
+        file.write(padding, static_cast<std::streamsize>(align(size) - size));
+    }
+
+    /**
+     * @brief Writes raw bytes into the index, padding them to the alignment.
+     */
+    void write_padded(std::ofstream &file, const void *data, std::uint64_t size)
+    {
+        file.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+        write_padding(file, size);
+    }
+}; // namespace
+
+CorpusIndex::CorpusIndex(const std::string &file_path) : file(file_path)
+{
+    if (this->file.size() < sizeof(CorpusIndex::header) || std::memcmp(this->file.data(), MAGIC, sizeof(MAGIC)) != 0)
+    {
+        throw std::runtime_error("File \"" + file_path + "\" is not a valid index!");
+    }
+
+    this->index_header = reinterpret_cast<const CorpusIndex::header *>(this->file.data());
+
+    if (this->index_header->byte_order != BYTE_ORDER_MARK)
+    {
+        throw std::runtime_error("Index \"" + file_path + "\" was created on a machine with different byte order!");
+    }
+
+    const CorpusIndex::header &header = *this->index_header;
+
+    // Every symbol and file takes at least a byte, which also keeps the sizes below from overflowing
+    if (header.symbol_count >= this->file.size() || header.file_count >= this->file.size())
+    {
+        throw std::runtime_error("Index \"" + file_path + "\" is corrupted!");
+    }
+
+    this->check_section(header.symbol_offsets, header.symbol_count + 1, sizeof(std::uint64_t));
+    this->check_section(header.files, header.file_count, sizeof(CorpusIndex::file_record));
+
+    const std::uint64_t *symbol_offsets = reinterpret_cast<const std::uint64_t *>(this->file.data() + header.symbol_offsets);
+    this->check_section(header.symbol_bytes, symbol_offsets[header.symbol_count], 1);
+
+    // Symbols have to follow each other, so a single check covers all of them
+    for (std::uint64_t i = 0; i < header.symbol_count; ++i)
+    {
+        if (symbol_offsets[i] > symbol_offsets[i + 1])
+        {
+            throw std::runtime_error("Index \"" + file_path + "\" is corrupted!");
+        }
+    }
+
+    this->files = reinterpret_cast<const CorpusIndex::file_record *>(this->file.data() + header.files);
+
+    for (std::uint64_t i = 0; i < header.file_count; ++i)
+    {
+        const CorpusIndex::file_record &record = this->files[i];
+
+        this->check_section(record.path_offset, record.path_length, 1);
+        this->check_section(record.words_offset, record.word_count, sizeof(std::uint32_t));
+        this->check_section(record.frequencies_offset, record.frequency_count, sizeof(CorpusIndex::frequency_record));
+    }
+}
+
+void CorpusIndex::check_section(std::uint64_t offset, std::uint64_t count, std::uint64_t element_size) const
+{
+    // Sections of larger elements are aligned, so they can be read in place
+    std::uint64_t alignment = (element_size > 1) ? ALIGNMENT : 1;
+
+    if (offset % alignment != 0 || offset > this->file.size() || count > (this->file.size() - offset) / element_size)
+    {
+        throw std::runtime_error("Index is corrupted, a section lies outside of the file!");
+    }
+}
+
+void CorpusIndex::save(const std::string &file_path, const SymbolTable &symbols, const std::vector<Statistics *> &stats, bool case_sensitive)
+{
+    // Computes the layout first, so every offset is known before anything is written
+    CorpusIndex::header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.byte_order = BYTE_ORDER_MARK;
+    header.flags = case_sensitive ? FLAG_CASE_SENSITIVE : 0;
+    header.file_count = stats.size();
+
+    // Words which do not occur in any file, for example from files deleted since the table was created, are dropped
+    // New IDs keep the order of the old ones, so the word counts stay sorted
+    const std::uint32_t UNUSED = SymbolTable::NOT_FOUND;
+    std::vector<std::uint32_t> remap(symbols.size(), UNUSED);
+    for (const auto &stat : stats)
+    {
+        for (const auto &frequency : stat->get_word_frequencies().get_counts())
+        {
+            remap[frequency.word] = 0;
+        }
+    }
+
+    std::vector<std::uint64_t> symbol_offsets;
+    symbol_offsets.push_back(0);
+    for (std::uint32_t id = 0; id < symbols.size(); ++id)
+    {
+        if (remap[id] != UNUSED)
+        {
+            remap[id] = symbol_offsets.size() - 1;
+            symbol_offsets.push_back(symbol_offsets.back() + symbols.get(id).size());
+        }
+    }
+
+    header.symbol_count = symbol_offsets.size() - 1;
+
+    header.symbol_offsets = align(sizeof(CorpusIndex::header));
+    header.symbol_bytes = header.symbol_offsets + align(symbol_offsets.size() * sizeof(std::uint64_t));
+    header.files = header.symbol_bytes + align(symbol_offsets.back());
+
+    std::vector<CorpusIndex::file_record> records;
+    records.reserve(stats.size());
+
+    std::uint64_t offset = header.files + align(stats.size() * sizeof(CorpusIndex::file_record));
+    for (const auto &stat : stats)
+    {
+        CorpusIndex::file_record record{};
+
+        record.stamp = stat->get_file_stamp();
+        record.path_offset = offset;
+        record.path_length = stat->get_file_path().size();
+        offset += align(record.path_length);
+
+        record.words_offset = offset;
+        record.word_count = stat->get_word_ids().size;
+        offset += align(record.word_count * sizeof(std::uint32_t));
+
+        record.frequencies_offset = offset;
+        record.frequency_count = stat->get_word_frequencies().get_counts().size();
+        offset += record.frequency_count * sizeof(CorpusIndex::frequency_record);
+
+        records.push_back(record);
+    }
+
+    std::ofstream file(file_path, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Could not create index \"" + file_path + "\"!");
+    }
+
+    write_padded(file, &header, sizeof(header));
+    write_padded(file, symbol_offsets.data(), symbol_offsets.size() * sizeof(std::uint64_t));
+
+    for (std::uint32_t id = 0; id < symbols.size(); ++id)
+    {
+        if (remap[id] != UNUSED)
+        {
+            std::string_view word = symbols.get(id);
+            file.write(word.data(), static_cast<std::streamsize>(word.size()));
+        }
+    }
+    write_padding(file, symbol_offsets.back());
+
+    write_padded(file, records.data(), records.size() * sizeof(CorpusIndex::file_record));
+
+    // Words are remapped in blocks, so the whole sequence is never copied
+    const std::size_t BLOCK_SIZE = 1 << 16;
+    std::vector<std::uint32_t> block(BLOCK_SIZE);
+
+    std::vector<CorpusIndex::frequency_record> frequencies;
+    for (const auto &stat : stats)
+    {
+        std::string path = stat->get_file_path();
+        write_padded(file, path.data(), path.size());
+
+        Statistics::word_span words = stat->get_word_ids();
+        for (std::size_t start = 0; start < words.size; start += BLOCK_SIZE)
+        {
+            std::size_t length = std::min(BLOCK_SIZE, words.size - start);
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                std::uint32_t word = words.data[start + i];
+
+                // Every word has to be counted, words from a corrupted index may not be
+                if (word >= remap.size() || remap[word] == UNUSED)
+                {
+                    throw std::runtime_error("Words of \"" + path + "\" do not match their word counts!");
+                }
+
+                block[i] = remap[word];
+            }
+
+            file.write(reinterpret_cast<const char *>(block.data()), static_cast<std::streamsize>(length * sizeof(std::uint32_t)));
+        }
+        write_padding(file, words.size * sizeof(std::uint32_t));
+
+        frequencies.clear();
+        for (const auto &frequency : stat->get_word_frequencies().get_counts())
+        {
+            frequencies.push_back(CorpusIndex::frequency_record{remap[frequency.word], 0, frequency.count});
+        }
+        file.write(reinterpret_cast<const char *>(frequencies.data()), static_cast<std::streamsize>(frequencies.size() * sizeof(CorpusIndex::frequency_record)));
+    }
+
+    file.close();
+    if (!file)
+    {
+        throw std::runtime_error("Could not write index \"" + file_path + "\"!");
+    }
+}
+
+std::uint64_t CorpusIndex::hash_content(const char *data, std::size_t size)
+{
+    std::uint64_t hash = 0x9E3779B97F4A7C15 ^ size;
+
+    // Mixes blocks of 8 bytes, the last block is padded by zeros
+    for (std::size_t offset = 0; offset < size; offset += 8)
+    {
+        std::uint64_t block = 0;
+        std::memcpy(&block, data + offset, std::min<std::size_t>(8, size - offset));
+
+        block = rotate_left(block * 0x87C37B91114253D5, 31) * 0x4CF5AD432745937F;
+        hash = rotate_left(hash ^ block, 27) * 5 + 0x52DCE729;
+    }
+
+    // Final avalanche, so every bit of the input affects every bit of the hash
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCD;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53;
+    hash ^= hash >> 33;
+
+    return hash;
+}
+
+bool CorpusIndex::is_case_sensitive() const
+{
+    return (this->index_header->flags & FLAG_CASE_SENSITIVE) != 0;
+}
+
+void CorpusIndex::load_symbols(SymbolTable &symbols) const
+{
+    const std::uint64_t *offsets = reinterpret_cast<const std::uint64_t *>(this->file.data() + this->index_header->symbol_offsets);
+    const char *bytes = this->file.data() + this->index_header->symbol_bytes;
+
+    for (std::uint64_t i = 0; i < this->index_header->symbol_count; ++i)
+    {
+        symbols.add_external(std::string_view(bytes + offsets[i], offsets[i + 1] - offsets[i]));
+    }
+}
+
+std::size_t CorpusIndex::get_file_count() const
+{
+    return this->index_header->file_count;
+}
+
+std::string CorpusIndex::get_file_path(std::size_t index) const
+{
+    const CorpusIndex::file_record &record = this->files[index];
+    return std::string(this->file.data() + record.path_offset, record.path_length);
+}
+
+CorpusIndex::file_stamp CorpusIndex::get_file_stamp(std::size_t index) const
+{
+    return this->files[index].stamp;
+}
+
+const std::uint32_t *CorpusIndex::get_words(std::size_t index) const
+{
+    return reinterpret_cast<const std::uint32_t *>(this->file.data() + this->files[index].words_offset);
+}
+
+std::size_t CorpusIndex::get_word_count(std::size_t index) const
+{
+    return this->files[index].word_count;
+}
+
+WordCountTable CorpusIndex::get_frequencies(std::size_t index) const
+{
+    const CorpusIndex::file_record &record = this->files[index];
+    const CorpusIndex::frequency_record *records = reinterpret_cast<const CorpusIndex::frequency_record *>(this->file.data() + record.frequencies_offset);
+
+    std::vector<WordCountTable::word_count> counts;
+    counts.reserve(record.frequency_count);
+
+    for (std::uint64_t i = 0; i < record.frequency_count; ++i)
+    {
+        // Counts are merged by ID, so they have to stay sorted and point into the symbol table
+        if (records[i].word >= this->index_header->symbol_count || (i > 0 && records[i].word <= records[i - 1].word))
+        {
+            throw std::runtime_error("Index is corrupted, word counts of \"" + this->get_file_path(index) + "\" are invalid!");
+        }
+
+        counts.push_back(WordCountTable::word_count{records[i].word, static_cast<long>(records[i].count)});
+    }
+
+    return WordCountTable(std::move(counts));
+}
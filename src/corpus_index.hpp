@@ -0,0 +1,172 @@
+#pragma once
+
+#include "mapped_file.hpp"
+#include "symbol_table.hpp"
+#include "word_count_table.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Statistics;
+
+/**
+ * @brief Binary index of an analyzed corpus, which is read back without tokenizing the files again.
+ * @note  The index holds the symbol table, word IDs and word counts of every file.
+ * Every section is aligned, so the loaded index is used in place through a memory mapped file.
+ * Numbers are stored in the byte order of the machine which created the index.
+ */
+class CorpusIndex
+{
+public:
+    // Header at the beginning of the index
+    struct header
+    {
+        char magic[8];
+        std::uint32_t byte_order;
+        std::uint32_t flags;
+        std::uint64_t symbol_count;
+        std::uint64_t file_count;
+        // Offsets of the sections from the beginning of the index
+        std::uint64_t symbol_offsets;
+        std::uint64_t symbol_bytes;
+        std::uint64_t files;
+    };
+
+    // State of a file when it was loaded, used to detect changed files
+    struct file_stamp
+    {
+        std::uint64_t size;
+        // Time of the last modification in ticks of the file system clock
+        std::int64_t modified;
+        std::uint64_t content_hash;
+    };
+
+    // Location of the data of a single file, offsets are from the beginning of the index
+    struct file_record
+    {
+        CorpusIndex::file_stamp stamp;
+        std::uint64_t path_offset;
+        std::uint64_t path_length;
+        std::uint64_t words_offset;
+        std::uint64_t word_count;
+        std::uint64_t frequencies_offset;
+        std::uint64_t frequency_count;
+    };
+
+    // Number of occurrences of a single word, with a fixed size on every platform
+    struct frequency_record
+    {
+        std::uint32_t word;
+        std::uint32_t reserved;
+        std::int64_t count;
+    };
+
+private:
+    MappedFile file;
+    const CorpusIndex::header *index_header;
+    const CorpusIndex::file_record *files;
+
+    /**
+     * @brief Checks that a section lies inside of the index.
+     * @note  Throws if the section is out of bounds or misaligned.
+     *
+     * @param offset        Offset of the section from the beginning of the index
+     * @param count         Number of elements in the section
+     * @param element_size  Size of a single element in bytes
+     */
+    void check_section(std::uint64_t offset, std::uint64_t count, std::uint64_t element_size) const;
+
+public:
+    /**
+     * @brief Maps an index into memory and validates its layout.
+     * @note  Throws if the file cannot be read or is not a valid index.
+     *
+     * @param file_path Path to the index
+     */
+    explicit CorpusIndex(const std::string &file_path);
+
+    CorpusIndex(const CorpusIndex &) = delete;
+    CorpusIndex &operator=(const CorpusIndex &) = delete;
+
+    /**
+     * @brief Writes an index of loaded files.
+     * @note  Throws if the file cannot be written. Words which do not occur in any of the files are left out.
+     *
+     * @param file_path         Path to the index
+     * @param symbols           Symbol table shared by every file
+     * @param stats             Loaded files, their IDs have to point into the symbol table
+     * @param case_sensitive    Were the words converted to lower case?
+     */
+    static void save(const std::string &file_path, const SymbolTable &symbols, const std::vector<Statistics *> &stats, bool case_sensitive);
+
+    /**
+     * @brief Hashes the content of a file, so changed files can be told apart from files which were only touched.
+     *
+     * @param data  Content of the file
+     * @param size  Size of the content in bytes
+     *
+     * @return std::uint64_t Hash of the content
+     */
+    static std::uint64_t hash_content(const char *data, std::size_t size);
+
+    /**
+     * @brief Returns whether the words were converted to lower case when the index was created.
+     */
+    bool is_case_sensitive() const;
+
+    /**
+     * @brief Adds every word of the index into an empty symbol table.
+     * @note  Words are not copied, the index has to outlive the table.
+     *
+     * @param symbols Empty symbol table
+     */
+    void load_symbols(SymbolTable &symbols) const;
+
+    /**
+     * @brief Returns the number of indexed files.
+     */
+    std::size_t get_file_count() const;
+
+    /**
+     * @brief Returns the path of an indexed file.
+     *
+     * @param index Index of the file, lower than get_file_count()
+     */
+    std::string get_file_path(std::size_t index) const;
+
+    /**
+     * @brief Returns the state of an indexed file when it was loaded.
+     *
+     * @param index Index of the file, lower than get_file_count()
+     */
+    CorpusIndex::file_stamp get_file_stamp(std::size_t index) const;
+
+    /**
+     * @brief Returns the word IDs of an indexed file.
+     *
+     * @param index Index of the file, lower than get_file_count()
+     *
+     * @return const std::uint32_t* Words of the file in order of appearance, kept inside of the mapped index
+     */
+    const std::uint32_t *get_words(std::size_t index) const;
+
+    /**
+     * @brief Returns the number of words of an indexed file.
+     *
+     * @param index Index of the file, lower than get_file_count()
+     */
+    std::size_t get_word_count(std::size_t index) const;
+
+    /**
+     * @brief Reads the word counts of an indexed file.
+     * @note  Throws if the counts are not sorted by a valid word ID.
+     *
+     * @param index Index of the file, lower than get_file_count()
+     *
+     * @return WordCountTable Counts of every distinct word of the file
+     */
+    WordCountTable get_frequencies(std::size_t index) const;
+};
@@ -0,0 +1,555 @@
+#include "file_reader.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TEXTANALYSIS_PREAD
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Only the kernel interface is used, through raw system calls, so no library is needed
+#if defined(__linux__) && (defined(__GNUC__) || defined(__clang__)) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#if defined(STATX_SIZE) && defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define TEXTANALYSIS_IO_URING
+#endif
+#endif
+#endif
+
+namespace
+{
+    // Larger files are mapped, reading them whole into buffers would hold too much memory at once
+    const std::size_t SMALL_FILE_LIMIT = 256 << 10;
+
+    // Mapped files are read ahead only up to this size, the rest is read while they are tokenized
+    const std::size_t PREFETCH_LIMIT = 8 << 20;
+
+    // Every file of a batch takes two entries, one for its open and one for its size
+    const unsigned int RING_ENTRIES = 64;
+
+    std::atomic<FileReader::Backend> selected_backend{FileReader::Backend::MMAP};
+}; // namespace
+
+#ifdef TEXTANALYSIS_IO_URING
+
+// Rings shared with the kernel, entries are added at the tail of the submission ring and taken from the head of the completion ring
+struct FileReader::ring
+{
+    int descriptor = -1;
+
+    void *rings = MAP_FAILED;
+    std::size_t rings_size = 0;
+
+    io_uring_sqe *sqes = static_cast<io_uring_sqe *>(MAP_FAILED);
+    std::size_t sqes_size = 0;
+
+    unsigned int *sq_tail = nullptr;
+    unsigned int *sq_mask = nullptr;
+    unsigned int *sq_array = nullptr;
+    unsigned int sq_entries = 0;
+
+    unsigned int *cq_head = nullptr;
+    unsigned int *cq_tail = nullptr;
+    unsigned int *cq_mask = nullptr;
+    io_uring_cqe *cqes = nullptr;
+
+    // Entries added since the last run
+    unsigned int queued = 0;
+
+    /**
+     * @brief Sets up the rings, throws if io_uring is not available.
+     */
+    explicit ring(unsigned int entries)
+    {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+
+        this->descriptor = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (this->descriptor < 0)
+        {
+            throw std::runtime_error("io_uring could not be set up.");
+        }
+
+        // Opening, reading and closing files through the ring came with Linux 5.6, as did this feature
+        if ((params.features & IORING_FEAT_RW_CUR_POS) == 0 || (params.features & IORING_FEAT_SINGLE_MMAP) == 0)
+        {
+            close(this->descriptor);
+            throw std::runtime_error("io_uring of this kernel cannot open files.");
+        }
+
+        // Both rings share a single mapping
+        this->rings_size = std::max<std::size_t>(params.sq_off.array + params.sq_entries * sizeof(unsigned int),
+                                                 params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+        this->rings = mmap(nullptr, this->rings_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->descriptor, IORING_OFF_SQ_RING);
+
+        this->sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        this->sqes = static_cast<io_uring_sqe *>(mmap(nullptr, this->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->descriptor, IORING_OFF_SQES));
+
+        if (this->rings == MAP_FAILED || this->sqes == MAP_FAILED)
+        {
+            this->release();
+            throw std::runtime_error("io_uring rings could not be mapped.");
+        }
+
+        char *base = static_cast<char *>(this->rings);
+        this->sq_tail = reinterpret_cast<unsigned int *>(base + params.sq_off.tail);
+        this->sq_mask = reinterpret_cast<unsigned int *>(base + params.sq_off.ring_mask);
+        this->sq_array = reinterpret_cast<unsigned int *>(base + params.sq_off.array);
+        this->sq_entries = params.sq_entries;
+
+        this->cq_head = reinterpret_cast<unsigned int *>(base + params.cq_off.head);
+        this->cq_tail = reinterpret_cast<unsigned int *>(base + params.cq_off.tail);
+        this->cq_mask = reinterpret_cast<unsigned int *>(base + params.cq_off.ring_mask);
+        this->cqes = reinterpret_cast<io_uring_cqe *>(base + params.cq_off.cqes);
+    }
+
+    ring(const ring &) = delete;
+    ring &operator=(const ring &) = delete;
+
+    ~ring()
+    {
+        this->release();
+    }
+
+    void release()
+    {
+        if (this->sqes != MAP_FAILED)
+        {
+            munmap(this->sqes, this->sqes_size);
+        }
+
+        if (this->rings != MAP_FAILED)
+        {
+            munmap(this->rings, this->rings_size);
+        }
+
+        close(this->descriptor);
+    }
+
+    /**
+     * @brief Adds an empty entry to the submission ring, at most sq_entries entries can be added before a run.
+     */
+    io_uring_sqe *next(std::uint8_t opcode, int fd, const void *address, unsigned int length, std::uint64_t offset, std::uint64_t user_data)
+    {
+        if (this->queued >= this->sq_entries)
+        {
+            throw std::logic_error("Too many io_uring entries in a single run!");
+        }
+
+        unsigned int tail = *this->sq_tail;
+        unsigned int index = tail & *this->sq_mask;
+
+        io_uring_sqe *sqe = &this->sqes[index];
+        std::memset(sqe, 0, sizeof(io_uring_sqe));
+        sqe->opcode = opcode;
+        sqe->fd = fd;
+        sqe->addr = reinterpret_cast<std::uint64_t>(address);
+        sqe->len = length;
+        sqe->off = offset;
+        sqe->user_data = user_data;
+
+        this->sq_array[index] = index;
+
+        // Kernel may read the entry as soon as it sees the new tail
+        __atomic_store_n(this->sq_tail, tail + 1, __ATOMIC_RELEASE);
+        ++this->queued;
+
+        return sqe;
+    }
+
+    /**
+     * @brief Submits every added entry and waits until all of them are completed.
+     *
+     * @param complete Called as complete(user_data, result) for every completion
+     */
+    template <typename Complete>
+    void run(Complete complete)
+    {
+        unsigned int submitted = 0;
+        unsigned int completed = 0;
+
+        while (completed < this->queued)
+        {
+            int result = static_cast<int>(syscall(__NR_io_uring_enter, this->descriptor, this->queued - submitted, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+            if (result < 0)
+            {
+                // Interrupted or temporarily out of resources, completions already made are reaped below
+                if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+                {
+                    throw std::runtime_error("io_uring could not submit requests: " + std::string(std::strerror(errno)));
+                }
+
+                result = 0;
+            }
+
+            submitted += result;
+
+            unsigned int head = *this->cq_head;
+            unsigned int tail = __atomic_load_n(this->cq_tail, __ATOMIC_ACQUIRE);
+            for (; head != tail; ++head)
+            {
+                const io_uring_cqe &cqe = this->cqes[head & *this->cq_mask];
+                complete(cqe.user_data, cqe.res);
+                ++completed;
+            }
+
+            __atomic_store_n(this->cq_head, head, __ATOMIC_RELEASE);
+        }
+
+        this->queued = 0;
+    }
+};
+
+#else
+
+struct FileReader::ring
+{
+};
+
+#endif
+
+std::string_view FileReader::file_content::view() const
+{
+    if (this->mapped)
+    {
+        return std::string_view(this->mapped->data(), this->mapped->size());
+    }
+
+    return std::string_view(this->buffer.get(), this->size);
+}
+
+FileReader::FileReader()
+{
+    this->backend = FileReader::get_backend();
+
+    if (this->backend == FileReader::Backend::IO_URING)
+    {
+#ifdef TEXTANALYSIS_IO_URING
+        try
+        {
+            this->uring = std::make_unique<FileReader::ring>(RING_ENTRIES);
+        }
+        catch (const std::exception &e)
+        {
+            // Kernels without io_uring, or with io_uring disabled, still read the files by pread
+            this->backend = FileReader::Backend::PREAD;
+        }
+#else
+        this->backend = FileReader::Backend::PREAD;
+#endif
+    }
+
+    if (!FileReader::is_supported(this->backend))
+    {
+        this->backend = FileReader::Backend::MMAP;
+    }
+}
+
+FileReader::~FileReader() = default;
+
+std::vector<FileReader::file_content> FileReader::read(const std::vector<std::string> &paths)
+{
+    std::vector<FileReader::file_content> contents(paths.size());
+
+    switch (this->backend)
+    {
+    case FileReader::Backend::IO_URING:
+        // Every file takes two entries of the ring, so larger batches are split
+        for (std::size_t start = 0; start < paths.size(); start += RING_ENTRIES / 2)
+        {
+            std::size_t end = std::min(paths.size(), start + RING_ENTRIES / 2);
+            std::vector<std::string> part(paths.begin() + start, paths.begin() + end);
+            std::vector<FileReader::file_content> part_contents(part.size());
+
+            this->read_io_uring(part, part_contents);
+            std::move(part_contents.begin(), part_contents.end(), contents.begin() + start);
+        }
+        break;
+    case FileReader::Backend::PREAD:
+        this->read_pread(paths, contents);
+        break;
+    case FileReader::Backend::MMAP:
+        for (std::size_t i = 0; i < paths.size(); ++i)
+        {
+            FileReader::map_file(paths[i], contents[i]);
+        }
+        break;
+    }
+
+    return contents;
+}
+
+void FileReader::map_file(const std::string &path, FileReader::file_content &content)
+{
+    try
+    {
+        content.mapped = std::make_unique<MappedFile>(path);
+        content.mapped->prefetch(PREFETCH_LIMIT);
+        content.is_read = true;
+    }
+    catch (const std::exception &e)
+    {
+        // File is read again by the tokenizer, which reports the error
+        content.mapped.reset();
+    }
+}
+
+void FileReader::read_pread(const std::vector<std::string> &paths, std::vector<FileReader::file_content> &contents)
+{
+#ifdef TEXTANALYSIS_PREAD
+    for (std::size_t i = 0; i < paths.size(); ++i)
+    {
+        int descriptor = open(paths[i].c_str(), O_RDONLY | O_CLOEXEC);
+        if (descriptor < 0)
+        {
+            continue;
+        }
+
+        struct stat file_stat;
+        if (fstat(descriptor, &file_stat) != 0)
+        {
+            close(descriptor);
+            continue;
+        }
+
+        std::size_t size = file_stat.st_size;
+        if (size > SMALL_FILE_LIMIT)
+        {
+            close(descriptor);
+            FileReader::map_file(paths[i], contents[i]);
+            continue;
+        }
+
+        FileReader::file_content &content = contents[i];
+        content.buffer.reset(new char[size]);
+        content.is_read = true;
+
+        // File may shrink while it is read, it then ends where the reads end
+        while (content.size < size)
+        {
+            ssize_t result = pread(descriptor, content.buffer.get() + content.size, size - content.size, content.size);
+            if (result < 0 && errno == EINTR)
+            {
+                continue;
+            }
+
+            if (result <= 0)
+            {
+                content.is_read = (result == 0);
+                break;
+            }
+
+            content.size += result;
+        }
+
+        close(descriptor);
+    }
+#else
+    static_cast<void>(paths);
+    static_cast<void>(contents);
+#endif
+}
+
+void FileReader::read_io_uring(const std::vector<std::string> &paths, std::vector<FileReader::file_content> &contents)
+{
+#ifdef TEXTANALYSIS_IO_URING
+    FileReader::ring &ring = *this->uring;
+    std::size_t count = paths.size();
+
+    std::vector<int> descriptors(count, -1);
+    std::vector<struct statx> stats(count);
+    std::vector<bool> is_stated(count, false);
+
+    // 1. Opens every file and finds its size, both only need the path so they are submitted together
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        io_uring_sqe *open = ring.next(IORING_OP_OPENAT, AT_FDCWD, paths[i].c_str(), 0, 0, i * 2);
+        open->open_flags = O_RDONLY | O_CLOEXEC;
+
+        ring.next(IORING_OP_STATX, AT_FDCWD, paths[i].c_str(), STATX_SIZE, reinterpret_cast<std::uint64_t>(&stats[i]), i * 2 + 1);
+    }
+
+    ring.run([&](std::uint64_t user_data, int result) {
+        std::size_t i = user_data / 2;
+
+        if (user_data % 2 == 0)
+        {
+            descriptors[i] = result;
+        }
+        else
+        {
+            is_stated[i] = (result == 0);
+        }
+    });
+
+    std::vector<std::size_t> sizes(count, 0);
+    std::vector<std::size_t> pending;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (descriptors[i] < 0 || !is_stated[i] || stats[i].stx_size > SMALL_FILE_LIMIT)
+        {
+            continue;
+        }
+
+        sizes[i] = stats[i].stx_size;
+        contents[i].buffer.reset(new char[sizes[i]]);
+        contents[i].is_read = true;
+
+        if (sizes[i] > 0)
+        {
+            pending.push_back(i);
+        }
+    }
+
+    // 2. Reads every small file at once, short reads are continued by another round
+    while (!pending.empty())
+    {
+        for (auto i : pending)
+        {
+            FileReader::file_content &content = contents[i];
+            ring.next(IORING_OP_READ, descriptors[i], content.buffer.get() + content.size, sizes[i] - content.size, content.size, i);
+        }
+
+        std::vector<std::size_t> unfinished;
+        ring.run([&](std::uint64_t i, int result) {
+            FileReader::file_content &content = contents[i];
+
+            if (result < 0)
+            {
+                content.is_read = false;
+            }
+            else if (result > 0)
+            {
+                content.size += result;
+
+                if (content.size < sizes[i])
+                {
+                    unfinished.push_back(i);
+                }
+            }
+
+            // Nothing read means the file shrank, it then ends where the reads end
+        });
+
+        pending = std::move(unfinished);
+    }
+
+    // 3. Closes every opened file
+    bool is_any_open = false;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (descriptors[i] >= 0)
+        {
+            ring.next(IORING_OP_CLOSE, descriptors[i], nullptr, 0, 0, i);
+            is_any_open = true;
+        }
+    }
+
+    if (is_any_open)
+    {
+        ring.run([](std::uint64_t, int) {});
+    }
+
+    // Large files are mapped like by the other backends, files which could not be opened are left unread
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (descriptors[i] >= 0 && is_stated[i] && stats[i].stx_size > SMALL_FILE_LIMIT)
+        {
+            FileReader::map_file(paths[i], contents[i]);
+        }
+    }
+#else
+    static_cast<void>(paths);
+    static_cast<void>(contents);
+#endif
+}
+
+FileReader::Backend FileReader::get_used_backend() const
+{
+    return this->backend;
+}
+
+bool FileReader::is_supported(FileReader::Backend backend)
+{
+    switch (backend)
+    {
+    case FileReader::Backend::MMAP:
+        return true;
+    case FileReader::Backend::PREAD:
+#ifdef TEXTANALYSIS_PREAD
+        return true;
+#else
+        return false;
+#endif
+    case FileReader::Backend::IO_URING:
+#ifdef TEXTANALYSIS_IO_URING
+    {
+        // Setting up a ring is the only reliable check, kernels may also disable io_uring at runtime
+        static const bool supported = [] {
+            try
+            {
+                FileReader::ring probe(2);
+                return true;
+            }
+            catch (const std::exception &e)
+            {
+                return false;
+            }
+        }();
+
+        return supported;
+    }
+#else
+        return false;
+#endif
+    }
+
+    return false;
+}
+
+void FileReader::set_backend(FileReader::Backend backend)
+{
+    selected_backend = backend;
+}
+
+FileReader::Backend FileReader::get_backend()
+{
+    return selected_backend;
+}
+
+FileReader::Backend FileReader::parse_backend(const std::string &name)
+{
+    for (auto backend : {FileReader::Backend::MMAP, FileReader::Backend::PREAD, FileReader::Backend::IO_URING})
+    {
+        if (FileReader::get_name(backend) == name)
+        {
+            return backend;
+        }
+    }
+
+    throw std::invalid_argument("Unknown file reader \"" + name + "\", use \"mmap\", \"pread\" or \"io_uring\".");
+}
+
+std::string FileReader::get_name(FileReader::Backend backend)
+{
+    switch (backend)
+    {
+    case FileReader::Backend::MMAP:
+        return "mmap";
+    case FileReader::Backend::PREAD:
+        return "pread";
+    case FileReader::Backend::IO_URING:
+        return "io_uring";
+    }
+
+    return "";
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "mapped_file.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Reads whole files in batches, so corpora of many small files do not pay for several system calls per file.
+ * @note  Small files are read into buffers, large files are memory mapped and their first pages are read ahead.
+ * Every thread reading files has to use its own reader.
+ */
+class FileReader
+{
+public:
+    // Ways of reading the small files, large files are always mapped
+    enum class Backend
+    {
+        // Every file is mapped, same as large files
+        MMAP,
+        // Files are opened and read by a few system calls each
+        PREAD,
+        // Opens, reads and closes of a whole batch are submitted at once through io_uring, Linux 5.6 or newer only
+        IO_URING
+    };
+
+    // Content of a single file
+    struct file_content
+    {
+        // Bytes of a small file, empty for mapped files
+        std::unique_ptr<char[]> buffer;
+        std::size_t size = 0;
+
+        // Large file or any file read by the MMAP backend
+        std::unique_ptr<MappedFile> mapped;
+
+        // Could the file be read? Unreadable files have to be read again to report the error
+        bool is_read = false;
+
+        /**
+         * @brief Returns the bytes of the file.
+         */
+        std::string_view view() const;
+    };
+
+private:
+    // Submission and completion rings of io_uring, created only by the IO_URING backend
+    struct ring;
+    std::unique_ptr<ring> uring;
+
+    Backend backend;
+
+public:
+    /**
+     * @brief Creates a reader using the selected backend.
+     * @note  Falls back to the PREAD backend if io_uring cannot be set up.
+     */
+    FileReader();
+
+    FileReader(const FileReader &) = delete;
+    FileReader &operator=(const FileReader &) = delete;
+
+    ~FileReader();
+
+    /**
+     * @brief Reads a batch of files.
+     * @note  Errors of single files are not thrown, the files are only marked as not read.
+     *
+     * @param paths Paths of the files
+     *
+     * @return std::vector<file_content> Content of every file in the order of the paths
+     */
+    std::vector<file_content> read(const std::vector<std::string> &paths);
+
+    /**
+     * @brief Returns the backend used by the reader.
+     *
+     * @return Backend Backend, PREAD if io_uring was selected but is not available
+     */
+    Backend get_used_backend() const;
+
+    /**
+     * @brief Returns whether the backend can be used on this system.
+     *
+     * @param backend Backend to be checked
+     */
+    static bool is_supported(Backend backend);
+
+    /**
+     * @brief Selects the backend of every reader created afterwards.
+     * @note  Unsupported io_uring is not an error, readers fall back to the PREAD backend.
+     *
+     * @param backend Selected backend
+     */
+    static void set_backend(Backend backend);
+
+    /**
+     * @brief Returns the selected backend.
+     *
+     * @return Backend Selected backend, MMAP by default
+     */
+    static Backend get_backend();
+
+    /**
+     * @brief Finds a backend by its name.
+     * @note  Throws if there is no backend of the name.
+     *
+     * @param name One of "mmap", "pread" or "io_uring"
+     *
+     * @return Backend Backend of the name
+     */
+    static Backend parse_backend(const std::string &name);
+
+    /**
+     * @brief Returns the name of a backend.
+     *
+     * @param backend Backend
+     *
+     * @return std::string Name accepted by parse_backend
+     */
+    static std::string get_name(Backend backend);
+
+private:
+    /**
+     * @brief Maps a file and reads its first pages ahead.
+     */
+    static void map_file(const std::string &path, file_content &content);
+
+    /**
+     * @brief Reads the files one by one with open, fstat, pread and close.
+     */
+    void read_pread(const std::vector<std::string> &paths, std::vector<file_content> &contents);
+
+    /**
+     * @brief Reads the files by submitting each step for the whole batch at once.
+     */
+    void read_io_uring(const std::vector<std::string> &paths, std::vector<file_content> &contents);
+};
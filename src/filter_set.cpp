@@ -0,0 +1,78 @@
+#include "filter_set.hpp"
+#include "case_folding.hpp"
+#include "utf8.hpp"
+
+namespace
+{
+    /**
+     * @brief Collects IDs of the filtered out words, folded the same way as the words of the files.
+     */
+    template <typename Lookup>
+    std::vector<std::uint32_t> collect_ids(const std::vector<std::wstring> &words, bool fold_case, Lookup lookup)
+    {
+        std::vector<std::uint32_t> ids;
+        ids.reserve(words.size());
+
+        std::string folded;
+        for (const auto &word : words)
+        {
+            std::string encoded = UTF8::encode(word);
+            std::uint32_t id = lookup(fold_case ? CaseFolding::fold(encoded, folded) : std::string_view(encoded));
+            if (id != SymbolTable::NOT_FOUND)
+            {
+                ids.push_back(id);
+            }
+        }
+
+        return ids;
+    }
+}; // namespace
+
+FilterSet::FilterSet(const std::vector<std::uint32_t> &ids)
+{
+    if (ids.empty())
+    {
+        return;
+    }
+
+    // At least twice as many slots as IDs keeps the probe sequences short
+    int bits = 3;
+    while ((std::size_t(1) << bits) < ids.size() * 2)
+    {
+        ++bits;
+    }
+
+    this->shift = 32 - bits;
+    this->slots.assign(std::size_t(1) << bits, SymbolTable::NOT_FOUND);
+
+    std::size_t mask = this->slots.size() - 1;
+    for (auto id : ids)
+    {
+        std::size_t slot = this->slot_of(id);
+        while (this->slots[slot] != SymbolTable::NOT_FOUND && this->slots[slot] != id)
+        {
+            slot = (slot + 1) & mask;
+        }
+
+        if (this->slots[slot] == SymbolTable::NOT_FOUND)
+        {
+            this->slots[slot] = id;
+            ++this->count;
+        }
+    }
+}
+
+FilterSet FilterSet::resolve(const std::vector<std::wstring> &words, const SymbolTable &symbols, bool fold_case)
+{
+    return FilterSet(collect_ids(words, fold_case, [&symbols](std::string_view word) { return symbols.find(word); }));
+}
+
+FilterSet FilterSet::intern(const std::vector<std::wstring> &words, SymbolTable &symbols, bool fold_case)
+{
+    return FilterSet(collect_ids(words, fold_case, [&symbols](std::string_view word) { return symbols.intern(word); }));
+}
+
+std::size_t FilterSet::size() const
+{
+    return this->count;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "symbol_table.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Set of filtered out word IDs with a lookup of constant cost.
+ * @note  IDs are kept in a flat open addressing table, at most half full, so a lookup touches one or two slots
+ * whatever the number of filtered words. The set is built once, when the filter is resolved.
+ */
+class FilterSet
+{
+private:
+    // Slots of the table, empty slots hold SymbolTable::NOT_FOUND
+    std::vector<std::uint32_t> slots;
+
+    // Table size is a power of two, the slot is taken from the top bits of the hash
+    int shift = 32;
+    std::size_t count = 0;
+
+    /**
+     * @brief Returns the first slot probed for an ID.
+     */
+    std::size_t slot_of(std::uint32_t id) const;
+
+public:
+    /**
+     * @brief Creates an empty set.
+     */
+    FilterSet() = default;
+
+    /**
+     * @brief Creates a set of IDs, duplicates are stored once.
+     *
+     * @param ids IDs of the filtered out words
+     */
+    explicit FilterSet(const std::vector<std::uint32_t> &ids);
+
+    /**
+     * @brief Looks up filtered out words in a symbol table.
+     * @note  Words which are not in the table cannot occur in the files and are left out.
+     *
+     * @param words         Filtered out words
+     * @param symbols       Symbol table of the files
+     * @param fold_case     Was case of the words in the table folded?
+     *
+     * @return FilterSet IDs of the words found in the table
+     */
+    static FilterSet resolve(const std::vector<std::wstring> &words, const SymbolTable &symbols, bool fold_case);
+
+    /**
+     * @brief Adds filtered out words into a symbol table, so they have IDs before any file is read.
+     * @note  Used while streaming, when words are filtered as soon as they are read.
+     *
+     * @param words         Filtered out words
+     * @param symbols       Symbol table receiving the words
+     * @param fold_case     Is case of the words in the table folded?
+     *
+     * @return FilterSet IDs of all of the words
+     */
+    static FilterSet intern(const std::vector<std::wstring> &words, SymbolTable &symbols, bool fold_case);
+
+    /**
+     * @brief Returns whether the word with the ID is filtered out.
+     *
+     * @param id ID of a word from the symbol table
+     */
+    bool contains(std::uint32_t id) const;
+
+    /**
+     * @brief Returns the number of filtered out IDs.
+     */
+    std::size_t size() const;
+};
+
+inline std::size_t FilterSet::slot_of(std::uint32_t id) const
+{
+    // Fibonacci hashing spreads consecutive IDs over the whole table
+    return static_cast<std::uint32_t>(id * 0x9E3779B1u) >> this->shift;
+}
+
+inline bool FilterSet::contains(std::uint32_t id) const
+{
+    if (this->count == 0)
+    {
+        return false;
+    }
+
+    // Table is never full, so every probe sequence ends at an empty slot
+    std::size_t mask = this->slots.size() - 1;
+    for (std::size_t slot = this->slot_of(id);; slot = (slot + 1) & mask)
+    {
+        if (this->slots[slot] == id)
+        {
+            return true;
+        }
+
+        if (this->slots[slot] == SymbolTable::NOT_FOUND)
+        {
+            return false;
+        }
+    }
+}
@@ -1,9 +1,11 @@
 #include "cmdline.hpp"
 #include "analyzer.hpp"
+#include "file_reader.hpp"
+#include "output_writer.hpp"
+#include "report.hpp"
 
 #include <iostream>
-#include <codecvt>
-#include <fstream>
+#include <memory>
 
 int main(int argc, char *argv[])
 {
@@ -19,72 +21,81 @@ int main(int argc, char *argv[])
             return 0;
         }
 
-        Analyzer analyzer = Analyzer(options.source_path, options.filtered_words, options.ignore_case);
+        if (options.cache_path != "" && (options.streaming || options.from_index))
+        {
+            throw std::invalid_argument("Incremental analysis cannot be used with streaming or an index as the source.");
+        }
+
+        FileReader::set_backend(FileReader::parse_backend(options.reader));
+
+        // Unknown format is rejected before any file is loaded
+        Report::Format format = Report::parse_format(options.format);
+
+        // Files are either read from the source path, loaded from a previously created index or partially from a cache
+        Analyzer analyzer = options.from_index
+                                ? Analyzer(std::make_shared<const CorpusIndex>(options.source_path), options.filtered_words, options.threads)
+                            : (options.cache_path != "")
+                                ? Analyzer(options.source_path, options.filtered_words, options.ignore_case, options.threads, options.cache_path)
+                                : Analyzer(options.source_path, options.filtered_words, options.ignore_case, options.threads, options.streaming, options.n_gram_size);
+
+        if (options.index_path != "")
+        {
+            analyzer.save_index(options.index_path);
+        }
 
         // Generating word clouds
         if (options.word_cloud)
         {
             if (options.per_file)
             {
-                analyzer.generate_word_cloud_per_file(options.target_path);
+                analyzer.generate_word_cloud_per_file(options.target_path, options.seed);
             }
             else
             {
-                analyzer.generate_word_cloud(options.target_path);
+                analyzer.generate_word_cloud(options.target_path, options.seed);
             }
 
             // No other execution happens after generation of word clouds
             return 0;
         }
 
-        // Sets wcout encoding to UTF-8
-        // otherwise some loaded characters would stop the standard output
-        // Unfortunately does not work on every platform or compiler
-        std::locale loc(std::locale::classic(), new std::codecvt_utf8<wchar_t>());
-
-        std::vector<std::wstring> analysis;
+        // Results are written as soon as they are computed, through a single buffer
+        std::unique_ptr<OutputWriter> writer = (options.target_path.size() > 0)
+                                                   ? std::make_unique<OutputWriter>(options.target_path)
+                                                   : std::make_unique<OutputWriter>(std::cout);
+        std::unique_ptr<Report> report = Report::create(format, *writer);
 
         // Generating analysis per file
         if (options.per_file)
         {
             if (options.print_words)
             {
-                analysis.push_back(L"Number of words per file:");
+                report->begin_section(Report::section{Report::Metric::WORDS, true, 0, 0});
 
-                for (auto word_count : analyzer.get_word_count_per_file())
+                for (const auto &word_count : analyzer.get_word_count_per_file())
                 {
-                    // File names are strings, thus needing conversion to wstring via iterator
-                    analysis.push_back(L"\t" + std::wstring(word_count.first.begin(), word_count.first.end()) + L"\t" + std::to_wstring(word_count.second));
+                    report->write_count(word_count.first, word_count.second);
                 }
             }
 
             if (options.print_unique)
             {
-                analysis.push_back(L"Number of unique words per file:");
+                report->begin_section(Report::section{Report::Metric::UNIQUE_WORDS, true, 0, 0});
 
-                for (auto word_count : analyzer.get_unique_word_count_per_file())
+                for (const auto &word_count : analyzer.get_unique_word_count_per_file())
                 {
-                    // File names are strings, thus needing conversion to wstring via iterator
-                    analysis.push_back(L"\t" + std::wstring(word_count.first.begin(), word_count.first.end()) + L"\t" + std::to_wstring(word_count.second));
+                    report->write_count(word_count.first, word_count.second);
                 }
             }
 
             if (options.n_gram_size > 0)
             {
-                analysis.push_back(L"5 most frequent " + std::to_wstring(options.n_gram_size) + L"-ngrams per file are:");
+                report->begin_section(Report::section{Report::Metric::N_GRAMS, true, options.n_gram_size, options.n_gram_count});
 
-                for (auto file_data : analyzer.generate_n_gram_per_file(options.n_gram_size))
-                {
-                    // File names are strings, thus needing conversion to wstring via iterator
-                    std::wstring file_gram = L"\t" + std::wstring(file_data.first.begin(), file_data.first.end()) + L"\t";
-
-                    for (auto gram : file_data.second)
-                    {
-                        file_gram += gram.value + L"(" + std::to_wstring(gram.count) + L"), ";
-                    }
-
-                    analysis.push_back(file_gram);
-                }
+                // N-grams of every file are written right away, they are never all kept at once
+                analyzer.generate_n_gram_per_file(options.n_gram_size, options.n_gram_count, [&report](const std::string &file_path, const std::vector<Statistics::n_gram> &n_grams) {
+                    report->write_n_grams(file_path, n_grams);
+                });
             }
         }
         // Generates overall analysis
@@ -92,59 +103,24 @@ int main(int argc, char *argv[])
         {
             if (options.print_words)
             {
-                analysis.push_back(L"Number of words:\t\t" + std::to_wstring(analyzer.get_word_count()));
+                report->begin_section(Report::section{Report::Metric::WORDS, false, 0, 0});
+                report->write_count("", analyzer.get_word_count());
             }
 
             if (options.print_unique)
             {
-                analysis.push_back(L"Number of unique words:\t\t" + std::to_wstring(analyzer.get_unique_word_count()));
+                report->begin_section(Report::section{Report::Metric::UNIQUE_WORDS, false, 0, 0});
+                report->write_count("", analyzer.get_unique_word_count());
             }
 
             if (options.n_gram_size > 0)
             {
-                std::wstring n_grams = L"5 most frequent " + std::to_wstring(options.n_gram_size) + L"-grams are:\t";
-
-                std::vector<Statistics::n_gram> pairs = analyzer.generate_n_gram(options.n_gram_size);
-                for (auto ngram : pairs)
-                {
-                    n_grams += ngram.value + L"(" + std::to_wstring(ngram.count) + L"), ";
-                }
-
-                analysis.push_back(n_grams);
-            }
-        }
-
-        if (options.target_path.size() > 0)
-        {
-            try
-            {
-                std::wofstream file_stream(options.target_path);
-                file_stream.imbue(loc);
-
-                for (auto line : analysis)
-                {
-                    file_stream << line << "\n";
-                }
-
-                file_stream.close();
-            }
-            catch (const std::exception &e)
-            {
-                throw std::runtime_error("Could not write analysis to a file " + options.target_path + ".");
+                report->begin_section(Report::section{Report::Metric::N_GRAMS, false, options.n_gram_size, options.n_gram_count});
+                report->write_n_grams("", analyzer.generate_n_gram(options.n_gram_size, options.n_gram_count));
             }
         }
-        else
-        {
-            std::wcout.imbue(loc);
 
-            for (auto line : analysis)
-            {
-                std::wcout << line << "\n";
-            }
-
-            // Locale has to be reset after printing to prevent memory leaks
-            std::wcout.imbue(std::locale::classic());
-        }
+        report->finish();
     }
     catch (const std::exception &e)
     {
@@ -0,0 +1,121 @@
+#include "mapped_file.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <sstream>
+#endif
+
+namespace
+{
+    // Smallest page size of common platforms, touching a byte every this many bytes reads every page
+    const std::size_t PAGE_SIZE = 4096;
+}; // namespace
+
+#if defined(__unix__) || defined(__APPLE__)
+
+MappedFile::MappedFile(const std::string &file_path)
+{
+    int descriptor = open(file_path.c_str(), O_RDONLY);
+    if (descriptor < 0)
+    {
+        throw std::runtime_error("Could not open file " + file_path + ".");
+    }
+
+    struct stat file_stat;
+    if (fstat(descriptor, &file_stat) != 0)
+    {
+        close(descriptor);
+        throw std::runtime_error("Could not read size of file " + file_path + ".");
+    }
+
+    this->length = file_stat.st_size;
+
+    // Empty files cannot be mapped, they are simply left without any data
+    if (this->length > 0)
+    {
+        void *address = mmap(nullptr, this->length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (address == MAP_FAILED)
+        {
+            close(descriptor);
+            throw std::runtime_error("Could not map file " + file_path + " into memory.");
+        }
+
+        // The file is read only once from start to end
+        // Kernel can read ahead aggressively and drop pages that were already read
+        madvise(address, this->length, MADV_SEQUENTIAL);
+
+        this->bytes = static_cast<const char *>(address);
+        this->mapped = true;
+    }
+
+    // The mapping stays valid after the file is closed
+    close(descriptor);
+}
+
+MappedFile::~MappedFile()
+{
+    if (this->mapped)
+    {
+        munmap(const_cast<char *>(this->bytes), this->length);
+    }
+}
+
+#else
+
+MappedFile::MappedFile(const std::string &file_path)
+{
+    std::ifstream file(file_path, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Could not open file " + file_path + ".");
+    }
+
+    std::stringstream content;
+    content << file.rdbuf();
+    this->buffer = content.str();
+
+    this->bytes = this->buffer.data();
+    this->length = this->buffer.size();
+}
+
+MappedFile::~MappedFile() = default;
+
+#endif
+
+const char *MappedFile::data() const
+{
+    return this->bytes;
+}
+
+std::size_t MappedFile::size() const
+{
+    return this->length;
+}
+
+void MappedFile::prefetch(std::size_t limit) const
+{
+    std::size_t length = std::min(limit, this->length);
+
+#if defined(__unix__) || defined(__APPLE__)
+    if (this->mapped && length > 0)
+    {
+        // Kernel starts reading every page at once, touching them below then mostly waits for reads already issued
+        madvise(const_cast<char *>(this->bytes), length, MADV_WILLNEED);
+    }
+#endif
+
+    // Volatile reads cannot be removed by the compiler even though their values are not used
+    const volatile char *bytes = this->bytes;
+    for (std::size_t offset = 0; offset < length; offset += PAGE_SIZE)
+    {
+        bytes[offset];
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Read only view of the whole content of a file.
+ * @note  On POSIX systems the file is memory mapped and read in place without copying.
+ * Other platforms read the file into a buffer.
+ */
+class MappedFile
+{
+private:
+    const char *bytes = nullptr;
+    std::size_t length = 0;
+
+    // Is the content mapped or stored in the buffer?
+    bool mapped = false;
+    std::string buffer;
+
+public:
+    /**
+     * @brief Maps the file into memory.
+     * @note  Throws if the file cannot be opened or mapped.
+     *
+     * @param file_path Path to a file
+     */
+    explicit MappedFile(const std::string &file_path);
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /**
+     * @brief Unmaps the file.
+     */
+    ~MappedFile();
+
+    /**
+     * @brief Returns the content of the file.
+     *
+     * @return const char* First byte of the file
+     */
+    const char *data() const;
+
+    /**
+     * @brief Returns the size of the file.
+     *
+     * @return std::size_t Size in bytes
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Reads the start of the file into memory now, instead of when its bytes are first accessed.
+     * @note  Touches a byte of every page, so the calling thread waits for the disk instead of the tokenizer.
+     *
+     * @param limit Maximum number of bytes read ahead
+     */
+    void prefetch(std::size_t limit) const;
+};
@@ -0,0 +1,240 @@
+#include "n_gram_table.hpp"
+#include "top_k.hpp"
+#include "utf8.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+    // Odd base of the polynomial rolling hash
+    const std::uint64_t BASE = 0x100000001B3ULL;
+
+    /**
+     * @brief Spreads bits of an ID, consecutive IDs would otherwise produce similar hashes.
+     */
+    std::uint64_t mix(std::uint32_t id)
+    {
+        return (static_cast<std::uint64_t>(id) + 1) * 0x9E3779B97F4A7C15ULL;
+    }
+
+    /**
+     * @brief Finalizes the hash before its top bits are used as a slot index.
+     */
+    std::uint64_t finalize(std::uint64_t hash)
+    {
+        hash ^= hash >> 31;
+        hash *= 0xBF58476D1CE4E5B9ULL;
+        hash ^= hash >> 29;
+        return hash;
+    }
+}; // namespace
+
+NGramTable::NGramTable(int size)
+{
+    if (size < 1)
+    {
+        throw std::invalid_argument("N-gram size was too small!");
+    }
+
+    this->size = size;
+    this->slot_bits = 4;
+    this->slots = std::vector<std::uint32_t>(std::size_t(1) << this->slot_bits, 0);
+}
+
+void NGramTable::count(const std::uint32_t *words, std::size_t word_count)
+{
+    if (word_count < static_cast<std::size_t>(this->size))
+    {
+        return;
+    }
+
+    std::uint64_t power = NGramTable::leaving_power(this->size);
+    std::uint64_t rolling = NGramTable::hash(words, this->size);
+
+    // The last window starts at word_count - size, so the final n-gram is counted as well
+    for (std::size_t i = 0; i + this->size <= word_count; ++i)
+    {
+        if (i > 0)
+        {
+            rolling = NGramTable::roll(rolling, words[i - 1], words[i + this->size - 1], power);
+        }
+
+        this->add(words + i, rolling, 1);
+    }
+}
+
+void NGramTable::add(const std::uint32_t *gram, std::uint64_t hash, long count)
+{
+    // Keeps the load factor at most 1/2, so probe sequences stay short
+    if ((this->counts.size() + 1) * 2 > this->slots.size())
+    {
+        this->grow();
+    }
+
+    std::size_t mask = this->slots.size() - 1;
+    std::size_t slot = finalize(hash) >> (64 - this->slot_bits);
+
+    while (this->slots[slot] != 0)
+    {
+        std::size_t index = this->slots[slot] - 1;
+
+        // Full comparison of the words is only needed when the hashes match
+        if (this->hashes[index] == hash && std::equal(gram, gram + this->size, this->grams.begin() + index * this->size))
+        {
+            this->counts[index] += count;
+            return;
+        }
+
+        slot = (slot + 1) & mask;
+    }
+
+    this->grams.insert(this->grams.end(), gram, gram + this->size);
+    this->counts.push_back(count);
+    this->hashes.push_back(hash);
+    this->slots[slot] = this->counts.size();
+}
+
+void NGramTable::merge(const NGramTable &other)
+{
+    if (other.size != this->size)
+    {
+        throw std::invalid_argument("Only n-grams of the same size can be merged!");
+    }
+
+    for (std::size_t i = 0; i < other.counts.size(); ++i)
+    {
+        this->add(other.get_gram(i), other.hashes[i], other.counts[i]);
+    }
+}
+
+void NGramTable::remap(const std::vector<std::uint32_t> &remap)
+{
+    for (auto &word : this->grams)
+    {
+        word = remap[word];
+    }
+
+    for (std::size_t index = 0; index < this->counts.size(); ++index)
+    {
+        this->hashes[index] = NGramTable::hash(this->get_gram(index), this->size);
+    }
+
+    // Slots depend on the hashes, so all n-grams are inserted again
+    this->rehash();
+}
+
+int NGramTable::get_size() const
+{
+    return this->size;
+}
+
+std::size_t NGramTable::get_distinct_count() const
+{
+    return this->counts.size();
+}
+
+const std::uint32_t *NGramTable::get_gram(std::size_t index) const
+{
+    return this->grams.data() + index * this->size;
+}
+
+long NGramTable::get_count(std::size_t index) const
+{
+    return this->counts.at(index);
+}
+
+std::wstring NGramTable::get_text(std::size_t index, const SymbolTable &symbols) const
+{
+    const std::uint32_t *gram = this->get_gram(index);
+
+    // Words are joined as UTF-8 and decoded once, instead of creating a string for every word
+    std::string text(symbols.get(gram[0]));
+    for (int i = 1; i < this->size; ++i)
+    {
+        text += ' ';
+        text += symbols.get(gram[i]);
+    }
+
+    return UTF8::decode(text);
+}
+
+std::vector<std::size_t> NGramTable::get_most_frequent(std::size_t count, const SymbolTable &symbols) const
+{
+    // Only the selected n-grams are ordered, the whole table is never sorted
+    // Text is compared only for n-grams with equal counts
+    return TopK::select(this->counts.size(), count,
+                        [&](std::size_t a, std::size_t b) {
+                            return this->counts[a] > this->counts[b] || (this->counts[a] == this->counts[b] && this->is_before(a, b, symbols));
+                        });
+}
+
+std::uint64_t NGramTable::hash(const std::uint32_t *gram, int size)
+{
+    std::uint64_t hash = 0;
+
+    for (int i = 0; i < size; ++i)
+    {
+        hash = hash * BASE + mix(gram[i]);
+    }
+
+    return hash;
+}
+
+std::uint64_t NGramTable::leaving_power(int size)
+{
+    // BASE^(size - 1) removes the contribution of the word leaving the window
+    std::uint64_t power = 1;
+    for (int i = 1; i < size; ++i)
+    {
+        power *= BASE;
+    }
+
+    return power;
+}
+
+std::uint64_t NGramTable::roll(std::uint64_t hash, std::uint32_t leaving, std::uint32_t entering, std::uint64_t power)
+{
+    return (hash - mix(leaving) * power) * BASE + mix(entering);
+}
+
+void NGramTable::grow()
+{
+    ++this->slot_bits;
+    this->rehash();
+}
+
+void NGramTable::rehash()
+{
+    this->slots.assign(std::size_t(1) << this->slot_bits, 0);
+
+    std::size_t mask = this->slots.size() - 1;
+
+    // Every n-gram is distinct, so only an empty slot has to be found
+    for (std::size_t index = 0; index < this->counts.size(); ++index)
+    {
+        std::size_t slot = finalize(this->hashes[index]) >> (64 - this->slot_bits);
+        while (this->slots[slot] != 0)
+        {
+            slot = (slot + 1) & mask;
+        }
+
+        this->slots[slot] = index + 1;
+    }
+}
+
+bool NGramTable::is_before(std::size_t a, std::size_t b, const SymbolTable &symbols) const
+{
+    const std::uint32_t *first = this->get_gram(a);
+    const std::uint32_t *second = this->get_gram(b);
+
+    for (int i = 0; i < this->size; ++i)
+    {
+        if (first[i] != second[i])
+        {
+            return symbols.get(first[i]) < symbols.get(second[i]);
+        }
+    }
+
+    return false;
+}
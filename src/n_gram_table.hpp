@@ -0,0 +1,172 @@
+#pragma once
+
+#include "symbol_table.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Counts n-grams of word IDs in an open addressing hash table.
+ * @note  Windows of words are hashed with a rolling hash, so moving the window by one word costs O(1).
+ * N-grams are kept as IDs, text is created only for the n-grams which are requested.
+ */
+class NGramTable
+{
+private:
+    // Number of words in a single n-gram
+    int size;
+
+    // IDs of every distinct n-gram, size IDs per n-gram in order of insertion
+    std::vector<std::uint32_t> grams;
+    std::vector<long> counts;
+    std::vector<std::uint64_t> hashes;
+
+    // Open addressing with linear probing, 0 marks an empty slot, otherwise index of the n-gram + 1
+    std::vector<std::uint32_t> slots;
+    unsigned int slot_bits = 0;
+
+public:
+    /**
+     * @brief Creates an empty table.
+     *
+     * @param size Size of the n-grams (n), has to be at least 1
+     */
+    explicit NGramTable(int size);
+
+    /**
+     * @brief Counts every n-gram of a sequence of words.
+     *
+     * @param words       Sequence of word IDs
+     * @param word_count  Number of words in the sequence
+     */
+    void count(const std::uint32_t *words, std::size_t word_count);
+
+    /**
+     * @brief Adds occurrences of a single n-gram.
+     *
+     * @param gram  First of size IDs of the n-gram
+     * @param hash  Hash of the n-gram computed by NGramTable::hash
+     * @param count Number of occurrences
+     */
+    void add(const std::uint32_t *gram, std::uint64_t hash, long count);
+
+    /**
+     * @brief Adds all n-grams of another table to this one.
+     * @note  Both tables have to use IDs from the same symbol table.
+     *
+     * @param other Table with n-grams of the same size
+     */
+    void merge(const NGramTable &other);
+
+    /**
+     * @brief Replaces every word ID with a new one.
+     * @note  The remapping has to be one to one, distinct n-grams have to stay distinct.
+     *
+     * @param remap New ID for every old ID
+     */
+    void remap(const std::vector<std::uint32_t> &remap);
+
+    /**
+     * @brief Returns the size of the n-grams (n).
+     *
+     * @return int Number of words in an n-gram
+     */
+    int get_size() const;
+
+    /**
+     * @brief Returns the number of distinct n-grams.
+     *
+     * @return std::size_t Number of distinct n-grams
+     */
+    std::size_t get_distinct_count() const;
+
+    /**
+     * @brief Returns the words of the n-gram at the index.
+     *
+     * @param index Index of the n-gram, lower than get_distinct_count()
+     *
+     * @return const std::uint32_t* First of size IDs of the n-gram
+     */
+    const std::uint32_t *get_gram(std::size_t index) const;
+
+    /**
+     * @brief Returns the number of occurrences of the n-gram at the index.
+     *
+     * @param index Index of the n-gram, lower than get_distinct_count()
+     *
+     * @return long Number of occurrences
+     */
+    long get_count(std::size_t index) const;
+
+    /**
+     * @brief Converts the n-gram at the index into text with words separated by space.
+     *
+     * @param index     Index of the n-gram, lower than get_distinct_count()
+     * @param symbols   Symbol table of the word IDs
+     *
+     * @return std::wstring Text of the n-gram
+     */
+    std::wstring get_text(std::size_t index, const SymbolTable &symbols) const;
+
+    /**
+     * @brief Finds the most frequent n-grams.
+     * @note  N-grams with equal count are ordered by their text.
+     *
+     * @param count     Maximum number of returned n-grams
+     * @param symbols   Symbol table of the word IDs
+     *
+     * @return std::vector<std::size_t> Indices of the n-grams in descending order by count
+     */
+    std::vector<std::size_t> get_most_frequent(std::size_t count, const SymbolTable &symbols) const;
+
+    /**
+     * @brief Computes the hash of an n-gram.
+     *
+     * @param gram  First of size IDs of the n-gram
+     * @param size  Number of words in the n-gram
+     *
+     * @return std::uint64_t Hash of the n-gram
+     */
+    static std::uint64_t hash(const std::uint32_t *gram, int size);
+
+    /**
+     * @brief Computes the factor removing the word which leaves a window, passed to NGramTable::roll.
+     *
+     * @param size  Number of words in the window
+     *
+     * @return std::uint64_t BASE to the power of size - 1
+     */
+    static std::uint64_t leaving_power(int size);
+
+    /**
+     * @brief Moves the hash of a window by a single word in constant time.
+     *
+     * @param hash      Hash of the window before the move
+     * @param leaving   ID of the first word of the window, which leaves it
+     * @param entering  ID of the word which enters the window
+     * @param power     Factor computed by NGramTable::leaving_power for the size of the window
+     *
+     * @return std::uint64_t Hash of the moved window, equal to NGramTable::hash of its words
+     */
+    static std::uint64_t roll(std::uint64_t hash, std::uint32_t leaving, std::uint32_t entering, std::uint64_t power);
+
+private:
+    /**
+     * @brief Doubles the number of slots and inserts all n-grams again.
+     */
+    void grow();
+
+    /**
+     * @brief Inserts all n-grams into empty slots again.
+     */
+    void rehash();
+
+    /**
+     * @brief Compares two n-grams by their text, word by word.
+     *
+     * @retval Is the first n-gram ordered before the second?
+     */
+    bool is_before(std::size_t a, std::size_t b, const SymbolTable &symbols) const;
+};
@@ -0,0 +1,72 @@
+#include "output_writer.hpp"
+#include "utf8.hpp"
+
+#include <stdexcept>
+
+OutputWriter::OutputWriter(std::ostream &stream)
+{
+    this->stream = &stream;
+    this->buffer = std::make_unique<char[]>(BUFFER_SIZE);
+}
+
+OutputWriter::OutputWriter(const std::string &file_path) : file(file_path, std::ios::binary)
+{
+    if (!this->file)
+    {
+        throw std::runtime_error("Could not write analysis to a file " + file_path + ".");
+    }
+
+    this->stream = &this->file;
+    this->file_path = file_path;
+    this->buffer = std::make_unique<char[]>(BUFFER_SIZE);
+}
+
+OutputWriter::~OutputWriter()
+{
+    try
+    {
+        this->flush();
+    }
+    catch (...)
+    {
+        // Destructor must not throw, the error was already reported if flush was called before
+    }
+}
+
+void OutputWriter::write_large(std::string_view bytes)
+{
+    this->flush();
+
+    // Large values are written straight into the stream, there is no point in copying them
+    if (bytes.size() >= BUFFER_SIZE)
+    {
+        this->stream->write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        return;
+    }
+
+    std::memcpy(this->buffer.get(), bytes.data(), bytes.size());
+    this->used = bytes.size();
+}
+
+void OutputWriter::write(std::wstring_view text)
+{
+    this->encoded.clear();
+    UTF8::append(this->encoded, text);
+    this->write(std::string_view(this->encoded));
+}
+
+void OutputWriter::flush()
+{
+    if (this->used > 0)
+    {
+        this->stream->write(this->buffer.get(), static_cast<std::streamsize>(this->used));
+        this->used = 0;
+    }
+
+    this->stream->flush();
+
+    if (!*this->stream)
+    {
+        throw std::runtime_error(this->file_path.empty() ? "Could not write analysis." : "Could not write analysis to a file " + this->file_path + ".");
+    }
+}
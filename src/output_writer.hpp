@@ -0,0 +1,133 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Buffered writer of UTF-8 encoded output.
+ * @note  Bytes are collected in a buffer of fixed size and written to the stream only when it is full,
+ * so writing many small values costs a single call per buffer instead of a call per value.
+ */
+class OutputWriter
+{
+private:
+    // Size of the buffer, every write to the stream but the last one is this large
+    static constexpr std::size_t BUFFER_SIZE = 1 << 16;
+
+    // File opened by the writer, unused when writing into a stream of the caller
+    std::ofstream file;
+    std::ostream *stream;
+    std::string file_path;
+
+    std::unique_ptr<char[]> buffer;
+    std::size_t used = 0;
+
+    // Reused for encoding of wide strings, so encoding does not allocate per value
+    std::string encoded;
+
+    /**
+     * @brief Writes bytes which do not fit into the rest of the buffer.
+     */
+    void write_large(std::string_view bytes);
+
+public:
+    /**
+     * @brief Creates a writer into a stream, for example the standard output.
+     *
+     * @param stream Stream receiving the bytes
+     */
+    explicit OutputWriter(std::ostream &stream);
+
+    /**
+     * @brief Creates a writer into a file.
+     * @note  Throws if the file cannot be created.
+     *
+     * @param file_path Path of the file
+     */
+    explicit OutputWriter(const std::string &file_path);
+
+    OutputWriter(const OutputWriter &) = delete;
+    OutputWriter &operator=(const OutputWriter &) = delete;
+
+    /**
+     * @brief Writes out the rest of the buffer, errors are not reported. Call flush to find out about them.
+     */
+    ~OutputWriter();
+
+    /**
+     * @brief Writes raw bytes.
+     *
+     * @param bytes Bytes to be written
+     */
+    void write(std::string_view bytes);
+
+    /**
+     * @brief Writes a wide string encoded into UTF-8.
+     *
+     * @param text Text to be written
+     */
+    void write(std::wstring_view text);
+
+    /**
+     * @brief Writes a single byte.
+     *
+     * @param byte Byte to be written
+     */
+    void write(char byte);
+
+    /**
+     * @brief Writes an integer in decimal, formatted straight into the buffer.
+     *
+     * @param value Integer to be written
+     */
+    void write_integer(long long value);
+
+    /**
+     * @brief Writes the buffer into the stream.
+     * @note  Throws if the stream fails.
+     */
+    void flush();
+};
+
+inline void OutputWriter::write(std::string_view bytes)
+{
+    // Values which do not fit are left to the slow path, which flushes the buffer first
+    if (BUFFER_SIZE - this->used < bytes.size())
+    {
+        this->write_large(bytes);
+        return;
+    }
+
+    std::memcpy(this->buffer.get() + this->used, bytes.data(), bytes.size());
+    this->used += bytes.size();
+}
+
+inline void OutputWriter::write(char byte)
+{
+    if (this->used == BUFFER_SIZE)
+    {
+        this->flush();
+    }
+
+    this->buffer[this->used++] = byte;
+}
+
+inline void OutputWriter::write_integer(long long value)
+{
+    // Longest integer has 19 digits and a sign
+    const std::size_t MAX_DIGITS = 20;
+
+    if (BUFFER_SIZE - this->used < MAX_DIGITS)
+    {
+        this->flush();
+    }
+
+    char *start = this->buffer.get() + this->used;
+    this->used = std::to_chars(start, start + MAX_DIGITS, value).ptr - this->buffer.get();
+}
@@ -0,0 +1,540 @@
+#include "report.hpp"
+#include "utf8.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+
+namespace
+{
+    /**
+     * @brief Lines of the original output, meant to be read by people.
+     */
+    class TextReport : public Report
+    {
+    public:
+        explicit TextReport(OutputWriter &writer) : Report(writer) {}
+
+        void begin_section(const Report::section &started) override
+        {
+            Report::begin_section(started);
+
+            if (!started.per_file)
+            {
+                return;
+            }
+
+            switch (started.metric)
+            {
+            case Report::Metric::WORDS:
+                this->writer.write("Number of words per file:\n");
+                break;
+            case Report::Metric::UNIQUE_WORDS:
+                this->writer.write("Number of unique words per file:\n");
+                break;
+            case Report::Metric::N_GRAMS:
+                this->writer.write_integer(started.n_gram_count);
+                this->writer.write(" most frequent ");
+                this->writer.write_integer(started.n_gram_size);
+                this->writer.write("-ngrams per file are:\n");
+                break;
+            }
+        }
+
+        void write_count(std::string_view file, long count) override
+        {
+            if (this->current.per_file)
+            {
+                this->write_file(file);
+            }
+            else
+            {
+                this->writer.write(std::string_view(this->current.metric == Report::Metric::WORDS ? "Number of words:\t\t" : "Number of unique words:\t\t"));
+            }
+
+            this->writer.write_integer(count);
+            this->writer.write('\n');
+        }
+
+        void write_n_grams(std::string_view file, const std::vector<Statistics::n_gram> &n_grams) override
+        {
+            if (this->current.per_file)
+            {
+                this->write_file(file);
+            }
+            else
+            {
+                this->writer.write_integer(this->current.n_gram_count);
+                this->writer.write(" most frequent ");
+                this->writer.write_integer(this->current.n_gram_size);
+                this->writer.write("-grams are:\t");
+            }
+
+            for (const auto &n_gram : n_grams)
+            {
+                this->writer.write(std::wstring_view(n_gram.value));
+                this->writer.write('(');
+                this->writer.write_integer(n_gram.count);
+                this->writer.write("), ");
+            }
+
+            this->writer.write('\n');
+        }
+
+    private:
+        void write_file(std::string_view file)
+        {
+            this->writer.write('\t');
+            this->writer.write(file);
+            this->writer.write('\t');
+        }
+    };
+
+    /**
+     * @brief JSON Lines, every count and every n-gram is a separate object.
+     */
+    class JsonReport : public Report
+    {
+    private:
+        // Start of every record of the current file, escaped once per file
+        std::string prefix;
+        std::string encoded;
+        std::string escaped;
+
+    public:
+        explicit JsonReport(OutputWriter &writer) : Report(writer) {}
+
+        void write_count(std::string_view file, long count) override
+        {
+            this->build_prefix(file);
+
+            this->writer.write(this->prefix);
+            this->writer.write(",\"count\":");
+            this->writer.write_integer(count);
+            this->writer.write("}\n");
+        }
+
+        void write_n_grams(std::string_view file, const std::vector<Statistics::n_gram> &n_grams) override
+        {
+            this->build_prefix(file);
+            this->prefix += ",\"size\":";
+            this->prefix += std::to_string(this->current.n_gram_size);
+            this->prefix += ",\"n_gram\":";
+
+            for (const auto &n_gram : n_grams)
+            {
+                this->encoded.clear();
+                UTF8::append(this->encoded, n_gram.value);
+
+                this->escaped.clear();
+                append_string(this->escaped, this->encoded);
+
+                this->writer.write(this->prefix);
+                this->writer.write(this->escaped);
+                this->writer.write(",\"count\":");
+                this->writer.write_integer(n_gram.count);
+                this->writer.write("}\n");
+            }
+        }
+
+    private:
+        void build_prefix(std::string_view file)
+        {
+            this->prefix = "{\"metric\":";
+            append_string(this->prefix, Report::get_metric_name(this->current.metric));
+
+            if (this->current.per_file)
+            {
+                this->prefix += ",\"file\":";
+                append_string(this->prefix, file);
+            }
+        }
+
+        /**
+         * @brief Appends a quoted and escaped string, bytes above ASCII are kept as they are.
+         */
+        static void append_string(std::string &result, std::string_view text)
+        {
+            static const char HEX_DIGITS[] = "0123456789abcdef";
+
+            result += '"';
+
+            // Runs of characters which need no escaping are appended at once
+            std::size_t start = 0;
+            for (std::size_t i = 0; i < text.size(); ++i)
+            {
+                unsigned char byte = static_cast<unsigned char>(text[i]);
+                if (byte >= 0x20 && byte != '"' && byte != '\\')
+                {
+                    continue;
+                }
+
+                result += text.substr(start, i - start);
+                start = i + 1;
+
+                switch (byte)
+                {
+                case '"':
+                    result += "\\\"";
+                    break;
+                case '\\':
+                    result += "\\\\";
+                    break;
+                case '\n':
+                    result += "\\n";
+                    break;
+                case '\r':
+                    result += "\\r";
+                    break;
+                case '\t':
+                    result += "\\t";
+                    break;
+                default:
+                    // Other control characters have no short escape
+                    result += "\\u00";
+                    result += HEX_DIGITS[byte >> 4];
+                    result += HEX_DIGITS[byte & 0x0F];
+                    break;
+                }
+            }
+
+            result += text.substr(start);
+            result += '"';
+        }
+    };
+
+    /**
+     * @brief Rows of delimited values with a header, either CSV or TSV.
+     * @note  CSV quotes fields as described by RFC 4180, TSV escapes tabs, line breaks and backslashes by a backslash.
+     */
+    class DelimitedReport : public Report
+    {
+    private:
+        char delimiter;
+
+        // Start of every row of the current file, escaped once per file
+        std::string prefix;
+        std::string encoded;
+        std::string escaped;
+
+    public:
+        DelimitedReport(OutputWriter &writer, char delimiter) : Report(writer), delimiter(delimiter)
+        {
+            for (std::string_view column : {"metric", "file", "size", "n_gram"})
+            {
+                this->writer.write(column);
+                this->writer.write(this->delimiter);
+            }
+
+            this->writer.write("count\n");
+        }
+
+        void write_count(std::string_view file, long count) override
+        {
+            this->build_prefix(file);
+
+            // Counts have no n-gram
+            this->prefix += this->delimiter;
+            this->prefix += this->delimiter;
+
+            this->writer.write(this->prefix);
+            this->writer.write_integer(count);
+            this->writer.write('\n');
+        }
+
+        void write_n_grams(std::string_view file, const std::vector<Statistics::n_gram> &n_grams) override
+        {
+            this->build_prefix(file);
+            this->prefix += std::to_string(this->current.n_gram_size);
+            this->prefix += this->delimiter;
+
+            for (const auto &n_gram : n_grams)
+            {
+                this->encoded.clear();
+                UTF8::append(this->encoded, n_gram.value);
+
+                this->escaped.clear();
+                this->append_field(this->escaped, this->encoded);
+                this->escaped += this->delimiter;
+
+                this->writer.write(this->prefix);
+                this->writer.write(this->escaped);
+                this->writer.write_integer(n_gram.count);
+                this->writer.write('\n');
+            }
+        }
+
+    private:
+        void build_prefix(std::string_view file)
+        {
+            this->prefix = Report::get_metric_name(this->current.metric);
+            this->prefix += this->delimiter;
+
+            // Counts of the whole input have no file
+            this->append_field(this->prefix, file);
+            this->prefix += this->delimiter;
+        }
+
+        void append_field(std::string &result, std::string_view field) const
+        {
+            if (this->delimiter == ',')
+            {
+                append_csv_field(result, field);
+            }
+            else
+            {
+                append_tsv_field(result, field);
+            }
+        }
+
+        static void append_csv_field(std::string &result, std::string_view field)
+        {
+            if (field.find_first_of(",\"\r\n") == std::string_view::npos)
+            {
+                result += field;
+                return;
+            }
+
+            // Quotes inside of a quoted field are doubled
+            result += '"';
+            for (char byte : field)
+            {
+                if (byte == '"')
+                {
+                    result += '"';
+                }
+
+                result += byte;
+            }
+            result += '"';
+        }
+
+        static void append_tsv_field(std::string &result, std::string_view field)
+        {
+            for (char byte : field)
+            {
+                switch (byte)
+                {
+                case '\t':
+                    result += "\\t";
+                    break;
+                case '\r':
+                    result += "\\r";
+                    break;
+                case '\n':
+                    result += "\\n";
+                    break;
+                case '\\':
+                    result += "\\\\";
+                    break;
+                default:
+                    result += byte;
+                    break;
+                }
+            }
+        }
+    };
+
+    /**
+     * @brief Sequence of MessagePack maps with the same keys as the JSON objects.
+     * @note  Every value takes the shortest encoding, numbers are written in big endian byte order.
+     */
+    class MessagePackReport : public Report
+    {
+    private:
+        // Every record is encoded here and written at once
+        std::string record;
+        std::string encoded;
+
+    public:
+        explicit MessagePackReport(OutputWriter &writer) : Report(writer) {}
+
+        void write_count(std::string_view file, long count) override
+        {
+            this->begin_record(file, 1);
+            append_string(this->record, "count");
+            append_integer(this->record, count);
+
+            this->writer.write(this->record);
+        }
+
+        void write_n_grams(std::string_view file, const std::vector<Statistics::n_gram> &n_grams) override
+        {
+            for (const auto &n_gram : n_grams)
+            {
+                this->begin_record(file, 3);
+                append_string(this->record, "size");
+                append_integer(this->record, this->current.n_gram_size);
+
+                this->encoded.clear();
+                UTF8::append(this->encoded, n_gram.value);
+                append_string(this->record, "n_gram");
+                append_string(this->record, this->encoded);
+
+                append_string(this->record, "count");
+                append_integer(this->record, n_gram.count);
+
+                this->writer.write(this->record);
+            }
+        }
+
+    private:
+        /**
+         * @brief Starts a map with the metric and the file, the entries are followed by the rest of the record.
+         */
+        void begin_record(std::string_view file, int entries)
+        {
+            // Metric and the file of per-file results
+            entries += this->current.per_file ? 2 : 1;
+
+            // Records never have more than 15 entries, so the map always fits a single byte
+            this->record.clear();
+            this->record += static_cast<char>(0x80 | entries);
+
+            append_string(this->record, "metric");
+            append_string(this->record, Report::get_metric_name(this->current.metric));
+
+            if (this->current.per_file)
+            {
+                append_string(this->record, "file");
+                append_string(this->record, file);
+            }
+        }
+
+        static void append_big_endian(std::string &result, std::uint64_t value, int bytes)
+        {
+            for (int shift = (bytes - 1) * 8; shift >= 0; shift -= 8)
+            {
+                result += static_cast<char>((value >> shift) & 0xFF);
+            }
+        }
+
+        static void append_string(std::string &result, std::string_view text)
+        {
+            if (text.size() < 32)
+            {
+                result += static_cast<char>(0xA0 | text.size());
+            }
+            else if (text.size() <= UINT8_MAX)
+            {
+                result += static_cast<char>(0xD9);
+                append_big_endian(result, text.size(), 1);
+            }
+            else if (text.size() <= UINT16_MAX)
+            {
+                result += static_cast<char>(0xDA);
+                append_big_endian(result, text.size(), 2);
+            }
+            else
+            {
+                result += static_cast<char>(0xDB);
+                append_big_endian(result, text.size(), 4);
+            }
+
+            result += text;
+        }
+
+        static void append_integer(std::string &result, long long value)
+        {
+            if (value >= -32 && value < 128)
+            {
+                // Positive and negative fixint hold the value in the marker itself
+                result += static_cast<char>(value);
+            }
+            else if (value > 0)
+            {
+                std::uint64_t unsigned_value = static_cast<std::uint64_t>(value);
+                int bytes = (unsigned_value <= UINT8_MAX) ? 1 : (unsigned_value <= UINT16_MAX) ? 2 : (unsigned_value <= UINT32_MAX) ? 4 : 8;
+
+                // Markers of unsigned integers of 1, 2, 4 and 8 bytes
+                result += static_cast<char>(bytes == 1 ? 0xCC : bytes == 2 ? 0xCD : bytes == 4 ? 0xCE : 0xCF);
+                append_big_endian(result, unsigned_value, bytes);
+            }
+            else
+            {
+                int bytes = (value >= INT8_MIN) ? 1 : (value >= INT16_MIN) ? 2 : (value >= INT32_MIN) ? 4 : 8;
+
+                // Markers of signed integers of 1, 2, 4 and 8 bytes
+                result += static_cast<char>(bytes == 1 ? 0xD0 : bytes == 2 ? 0xD1 : bytes == 4 ? 0xD2 : 0xD3);
+                append_big_endian(result, static_cast<std::uint64_t>(value), bytes);
+            }
+        }
+    };
+}; // namespace
+
+Report::Report(OutputWriter &writer) : writer(writer)
+{
+}
+
+std::unique_ptr<Report> Report::create(Report::Format format, OutputWriter &writer)
+{
+    switch (format)
+    {
+    case Report::Format::JSON:
+        return std::make_unique<JsonReport>(writer);
+    case Report::Format::CSV:
+        return std::make_unique<DelimitedReport>(writer, ',');
+    case Report::Format::TSV:
+        return std::make_unique<DelimitedReport>(writer, '\t');
+    case Report::Format::MSGPACK:
+        return std::make_unique<MessagePackReport>(writer);
+    default:
+        return std::make_unique<TextReport>(writer);
+    }
+}
+
+Report::Format Report::parse_format(const std::string &name)
+{
+    for (auto format : {Report::Format::TEXT, Report::Format::JSON, Report::Format::CSV, Report::Format::TSV, Report::Format::MSGPACK})
+    {
+        if (Report::get_name(format) == name)
+        {
+            return format;
+        }
+    }
+
+    throw std::invalid_argument("Unknown output format \"" + name + "\", use \"text\", \"json\", \"csv\", \"tsv\" or \"msgpack\".");
+}
+
+std::string Report::get_name(Report::Format format)
+{
+    switch (format)
+    {
+    case Report::Format::TEXT:
+        return "text";
+    case Report::Format::JSON:
+        return "json";
+    case Report::Format::CSV:
+        return "csv";
+    case Report::Format::TSV:
+        return "tsv";
+    case Report::Format::MSGPACK:
+        return "msgpack";
+    }
+
+    return "";
+}
+
+std::string_view Report::get_metric_name(Report::Metric metric)
+{
+    switch (metric)
+    {
+    case Report::Metric::WORDS:
+        return "words";
+    case Report::Metric::UNIQUE_WORDS:
+        return "unique_words";
+    case Report::Metric::N_GRAMS:
+        return "n_grams";
+    }
+
+    return "";
+}
+
+void Report::begin_section(const Report::section &started)
+{
+    this->current = started;
+}
+
+void Report::finish()
+{
+    this->writer.flush();
+}
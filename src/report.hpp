@@ -0,0 +1,129 @@
+#pragma once
+
+#include "output_writer.hpp"
+#include "statistics.hpp"
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Writes results of the analysis in one of the output formats.
+ * @note  Results are written as soon as they are passed in, nothing is kept, so the size of the report
+ * does not depend on the number of files. Results are grouped into sections, every section holds one kind of result.
+ */
+class Report
+{
+public:
+    enum class Format
+    {
+        // Human readable lines, the original output of the program
+        TEXT,
+        // JSON Lines, a single object per line
+        JSON,
+        // Comma separated values with a header row
+        CSV,
+        // Tab separated values with a header row
+        TSV,
+        // Sequence of MessagePack maps
+        MSGPACK
+    };
+
+    // Kind of results in a section
+    enum class Metric
+    {
+        WORDS,
+        UNIQUE_WORDS,
+        N_GRAMS
+    };
+
+    // Results written after begin_section, until the next section begins
+    struct section
+    {
+        Metric metric;
+
+        // Is every result written for a single file?
+        bool per_file;
+
+        // Size of the n-grams and the maximum number of n-grams of a single result, used only by N_GRAMS
+        int n_gram_size;
+        int n_gram_count;
+    };
+
+protected:
+    OutputWriter &writer;
+    section current{};
+
+    /**
+     * @brief Creates a report written by the writer.
+     */
+    explicit Report(OutputWriter &writer);
+
+public:
+    virtual ~Report() = default;
+
+    /**
+     * @brief Creates a report of the format.
+     *
+     * @param format Output format
+     * @param writer Writer receiving the report, has to outlive the report
+     *
+     * @return std::unique_ptr<Report> Report writing in the format
+     */
+    static std::unique_ptr<Report> create(Format format, OutputWriter &writer);
+
+    /**
+     * @brief Finds a format by its name.
+     * @note  Throws if there is no format of the name.
+     *
+     * @param name One of "text", "json", "csv", "tsv" or "msgpack"
+     *
+     * @return Format Format of the name
+     */
+    static Format parse_format(const std::string &name);
+
+    /**
+     * @brief Returns the name of a format.
+     *
+     * @param format Format
+     *
+     * @return std::string Name accepted by parse_format
+     */
+    static std::string get_name(Format format);
+
+    /**
+     * @brief Starts a section of results.
+     *
+     * @param started Kind of the following results
+     */
+    virtual void begin_section(const section &started);
+
+    /**
+     * @brief Writes a number of words of a WORDS or UNIQUE_WORDS section.
+     *
+     * @param file  Path of the file, empty if the count is for the whole input
+     * @param count Number of words
+     */
+    virtual void write_count(std::string_view file, long count) = 0;
+
+    /**
+     * @brief Writes the most frequent n-grams of a N_GRAMS section.
+     *
+     * @param file      Path of the file, empty if the n-grams are for the whole input
+     * @param n_grams   N-grams in descending order by count
+     */
+    virtual void write_n_grams(std::string_view file, const std::vector<Statistics::n_gram> &n_grams) = 0;
+
+    /**
+     * @brief Writes out everything written so far.
+     * @note  Throws if the output cannot be written.
+     */
+    void finish();
+
+protected:
+    /**
+     * @brief Returns the name of the metric used by the structured formats.
+     */
+    static std::string_view get_metric_name(Metric metric);
+};
@@ -1,158 +1,283 @@
 #include "statistics.hpp"
+#include "case_folding.hpp"
+#include "mapped_file.hpp"
+#include "tokenizer.hpp"
+#include "utf8.hpp"
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
-#include <codecvt>
 #include <iostream>
-#include <map>
-#include <regex>
 #include <string>
 
 namespace fs = std::filesystem;
 
+// Size of a single chunk read from a file in streaming mode
+const std::size_t STREAM_CHUNK_SIZE = 1 << 20;
+
 Statistics::Statistics(std::string file_path, bool case_sensitive)
 {
-    this->words = std::vector<std::wstring>();
-    this->filter = std::vector<std::wstring>();
+    this->words = std::vector<std::uint32_t>();
+    this->symbols = std::make_shared<SymbolTable>();
+    this->filter_words = std::vector<std::wstring>();
     this->file_path = file_path;
     this->case_sensitive = case_sensitive;
 }
 
 Statistics::Statistics(std::string file_path, std::vector<std::wstring> filter, bool case_sensitive)
 {
-    this->words = std::vector<std::wstring>();
-    this->filter = filter;
+    this->words = std::vector<std::uint32_t>();
+    this->symbols = std::make_shared<SymbolTable>();
+    this->filter_words = filter;
     this->file_path = file_path;
     this->case_sensitive = case_sensitive;
 }
 
-int Statistics::get_word_count()
+Statistics::Statistics(std::shared_ptr<const CorpusIndex> index, std::size_t file, std::shared_ptr<SymbolTable> symbols, std::vector<std::wstring> filter)
 {
-    std::vector<std::wstring> result;
+    this->words = std::vector<std::uint32_t>();
+    this->index = index;
+    this->index_file = file;
+    this->symbols = symbols;
+    this->filter_words = filter;
+    this->file_path = index->get_file_path(file);
+    this->case_sensitive = index->is_case_sensitive();
+    this->stamp = index->get_file_stamp(file);
+}
 
-    for (auto const &word : this->words)
+int Statistics::get_word_count()
+{
+    if (!this->word_count)
     {
-        // Only using non-filtered words
-        if (std::find(this->filter.begin(), this->filter.end(), word) == this->filter.end())
+        long count = 0;
+
+        for (auto const &frequency : this->get_filtered_frequencies().get_counts())
         {
-            result.push_back(word);
+            count += frequency.count;
         }
+
+        this->word_count = count;
     }
 
-    return result.size();
+    return *this->word_count;
 }
 
 int Statistics::get_unqiue_word_count()
 {
-    std::vector<std::wstring> result;
+    // Every word in the frequency table is unique
+    return this->get_filtered_frequencies().get_counts().size();
+}
 
-    for (auto const &word : this->words)
+NGramTable Statistics::count_n_grams(int size)
+{
+    if (this->streaming)
     {
-        // Temporary variables used to remove long line
-        // And to enhance readibility
-        bool is_not_duplicate = std::find(result.begin(), result.end(), word) == result.end();
-        bool is_not_filtered = std::find(this->filter.begin(), this->filter.end(), word) == this->filter.end();
-
-        if (is_not_duplicate && is_not_filtered)
+        auto streamed = this->streamed_n_grams.find(size);
+        if (streamed == this->streamed_n_grams.end())
         {
-            result.push_back(word);
+            throw std::invalid_argument("N-grams of size " + std::to_string(size) + " were not counted while streaming " + this->file_path + "!");
         }
+
+        return streamed->second;
     }
 
-    return result.size();
+    NGramTable grams(size);
+    Statistics::word_span words = this->get_filtered_word_ids();
+    grams.count(words.data, words.size);
+
+    return grams;
 }
 
-std::vector<Statistics::n_gram> Statistics::get_n_grams(int size)
+const NGramTable &Statistics::get_n_gram_table(int size)
 {
-    // Hashmap is used for better performance than just going
-    // through a vector of n-grams and comparing their counts
-    std::map<std::wstring, long> grams;
-    for (unsigned long i = 0; i + size < words.size(); ++i)
+    auto found = this->n_gram_tables.find(size);
+    if (found == this->n_gram_tables.end())
     {
-        // Creates n-gram of length defined by size
-        std::wstring gram = words.at(i);
-        for (int j = 1; j < size; ++j)
-        {
-            gram += L" " + words.at(i + j);
-        }
+        found = this->n_gram_tables.emplace(size, this->count_n_grams(size)).first;
+    }
 
-        // If n-gram is new, 0 is inserted into it's place before incrementation
-        if (grams.find(gram) == grams.end())
-        {
-            grams.emplace(gram, 0);
-        }
+    return found->second;
+}
+
+std::vector<Statistics::n_gram> Statistics::get_n_grams(int size, std::size_t count)
+{
+    return this->select_n_grams(this->get_n_gram_table(size), count);
+}
 
-        ++grams.at(gram);
+std::vector<Statistics::n_gram> Statistics::find_n_grams(int size, std::size_t count)
+{
+    auto found = this->n_gram_tables.find(size);
+    if (found != this->n_gram_tables.end())
+    {
+        return this->select_n_grams(found->second, count);
     }
 
-    // Converts the map into a vector of n-gram
+    // Table lives only until the n-grams are selected
+    return this->select_n_grams(this->count_n_grams(size), count);
+}
+
+std::vector<Statistics::n_gram> Statistics::select_n_grams(const NGramTable &grams, std::size_t count)
+{
+    // Only the selected n-grams are converted into text
     std::vector<Statistics::n_gram> result;
-    for (std::map<std::wstring, long>::iterator it = grams.begin(); it != grams.end(); ++it)
+    for (auto index : grams.get_most_frequent(count, *this->symbols))
     {
-        result.push_back(Statistics::n_gram{it->first, it->second});
+        result.push_back(Statistics::n_gram{grams.get_text(index, *this->symbols), grams.get_count(index)});
     }
 
-    // Sorts the vector by counts of n-gram occurences in descending order
-    std::sort(result.begin(), result.end(),
-              [](const Statistics::n_gram &a, const Statistics::n_gram &b) {
-                  return a.count > b.count;
-              });
-
     return result;
 }
 
 std::vector<std::wstring> Statistics::get_words()
 {
-    return this->words;
+    if (this->streaming)
+    {
+        throw std::logic_error("Words of " + this->file_path + " are not kept in streaming mode!");
+    }
+
+    std::vector<std::wstring> result;
+    Statistics::word_span words = this->get_word_ids();
+    result.reserve(words.size);
+
+    for (auto word : words)
+    {
+        result.push_back(this->symbols->get_wstring(word));
+    }
+
+    return result;
 }
 
-std::vector<std::wstring> Statistics::parse_file()
+Statistics::word_span Statistics::get_word_ids()
 {
-    std::vector<std::wstring> result;
+    if (this->index)
+    {
+        return Statistics::word_span{this->index->get_words(this->index_file), this->index->get_word_count(this->index_file)};
+    }
 
-    if (fs::is_regular_file(this->file_path))
+    return Statistics::word_span{this->words.data(), this->words.size()};
+}
+
+const WordCountTable &Statistics::get_word_frequencies()
+{
+    return this->frequencies;
+}
+
+Statistics::word_span Statistics::get_filtered_word_ids()
+{
+    if (this->filter.size() == 0)
     {
-        try
+        return this->get_word_ids();
+    }
+
+    if (!this->filtered_words)
+    {
+        Statistics::word_span words = this->get_word_ids();
+
+        std::vector<std::uint32_t> kept;
+        kept.reserve(words.size);
+
+        for (auto word : words)
         {
-            // Opens the file with UTF-8 encoding
-            std::ifstream f(this->file_path);
-            std::wbuffer_convert<std::codecvt_utf8<wchar_t>> conv(f.rdbuf());
-            std::wistream wf(&conv);
-
-            // Reads the whole file into a string of wide chars
-            std::wstring file_content;
-            for (wchar_t c; wf.get(c);)
+            if (!this->filter.contains(word))
             {
-                file_content += c;
+                kept.push_back(word);
             }
+        }
 
-            f.close();
+        this->filtered_words = std::move(kept);
+    }
 
-            // Splits file content using a REGEX expression into separate words
-            std::wregex delimiters(L"[^\\.,:;!”„“=…?() \n\"]+");
-            auto file_begin = std::wsregex_iterator(file_content.begin(), file_content.end(), delimiters);
-            auto file_end = std::wsregex_iterator();
+    return Statistics::word_span{this->filtered_words->data(), this->filtered_words->size()};
+}
+
+const WordCountTable &Statistics::get_filtered_frequencies()
+{
+    if (this->filter.size() == 0)
+    {
+        return this->frequencies;
+    }
+
+    if (!this->filtered_frequencies)
+    {
+        // Counts are sorted by ID, leaving some of them out keeps them sorted
+        std::vector<WordCountTable::word_count> kept;
+        kept.reserve(this->frequencies.get_counts().size());
 
-            // Iterates over split words and adds them into a final vector
-            for (std::wsregex_iterator it = file_begin; it != file_end; ++it)
+        for (auto const &frequency : this->frequencies.get_counts())
+        {
+            if (!this->filter.contains(frequency.word))
             {
-                auto word = (*it).str();
+                kept.push_back(frequency);
+            }
+        }
 
-                if (this->case_sensitive)
-                {
-                    // Converts all characters to lower case
-                    std::transform(word.begin(), word.end(), word.begin(), ::tolower);
-                }
+        this->filtered_frequencies.emplace(std::move(kept));
+    }
 
-                result.push_back(word);
+    return *this->filtered_frequencies;
+}
+
+const SymbolTable &Statistics::get_symbols()
+{
+    return *this->symbols;
+}
+
+void Statistics::share_symbols(std::shared_ptr<SymbolTable> symbols)
+{
+    // Maps every ID of the current table to an ID in the shared one
+    std::vector<std::uint32_t> remap(this->symbols->size());
+    for (std::uint32_t id = 0; id < remap.size(); ++id)
+    {
+        remap.at(id) = symbols->intern(this->symbols->get(id));
+    }
+
+    for (auto &word : this->words)
+    {
+        word = remap[word];
+    }
+
+    this->frequencies.remap(remap);
+
+    for (auto &grams : this->streamed_n_grams)
+    {
+        grams.second.remap(remap);
+    }
+
+    this->symbols = symbols;
+    this->resolve_filter();
+
+    // Kept n-grams hold the old IDs
+    this->clear_results();
+}
+
+std::vector<std::uint32_t> Statistics::parse_file(SymbolTable &symbols)
+{
+    std::vector<std::uint32_t> result;
+
+    if (fs::is_regular_file(this->file_path))
+    {
+        try
+        {
+            // Modification time is read first, so a change during reading is detected next time
+            std::int64_t modified = this->stamping ? fs::last_write_time(this->file_path).time_since_epoch().count() : 0;
+
+            // Maps the raw UTF-8 bytes of the whole file into memory
+            // Tokenizer reads them in place, nothing is copied until a new word is found
+            MappedFile file_content(this->file_path);
+
+            if (this->stamping)
+            {
+                this->stamp = CorpusIndex::file_stamp{file_content.size(), modified, CorpusIndex::hash_content(file_content.data(), file_content.size())};
             }
+
+            result = this->parse_content(symbols, std::string_view(file_content.data(), file_content.size()));
         }
         catch (const std::exception &e)
         {
             // Error during reading of a single file is not fatal error
             // It could be 1 file out of 100, so user is only informed that the file could not be read.
-            std::cerr << "File " << this->file_path << " could not be parsed due to an error!";
-            std::cerr << e.what() << '\n';
+            // Message is written at once so that it does not interleave with errors from other threads
+            std::cerr << "File " + this->file_path + " could not be parsed due to an error!" + e.what() + "\n";
         }
     }
     else
@@ -165,9 +290,160 @@ std::vector<std::wstring> Statistics::parse_file()
     return result;
 }
 
+std::vector<std::uint32_t> Statistics::parse_content(SymbolTable &symbols, std::string_view content)
+{
+    std::vector<std::uint32_t> result;
+
+    // Buffer for lower case words, reused to avoid an allocation per word
+    std::string lower_case;
+
+    // Splits the bytes into words in a single pass
+    // Each word is stored only once in the symbol table, the file keeps just its ID
+    Tokenizer::tokenize(content.data(), content.size(), [&](const Tokenizer::Token &token) {
+        std::string_view word(content.data() + token.offset, token.length);
+        result.push_back(this->intern_word(symbols, word, token.is_folded, lower_case));
+    });
+
+    return result;
+}
+
+void Statistics::stream_file(SymbolTable &symbols)
+{
+    if (!fs::is_regular_file(this->file_path))
+    {
+        // Input path is not a regular file and thus cannot be read
+        throw std::invalid_argument("File " + this->file_path + " is not a valid text file!");
+    }
+
+    // Counts indexed by ID, IDs of a fresh table are assigned in order
+    std::vector<long> counts;
+
+    // N-grams are counted while reading, so filtered words are left out of them right away
+    // Filtered words are added into the table first, so their IDs are known before they occur in the file
+    FilterSet read_filter = FilterSet::intern(this->filter_words, symbols, this->case_sensitive);
+
+    // Last words of the file in a buffer of twice the n-gram size, the current window is always contiguous
+    // When the buffer is full, the last window is moved to its front, which costs O(1) per word on average
+    int size = this->streamed_n_gram_size;
+    std::vector<std::uint32_t> window(size > 0 ? 2 * size : 0);
+    std::size_t window_end = 0;
+    std::size_t window_words = 0;
+
+    // Hash of the current window, moved by a single word without hashing the whole window again
+    std::uint64_t rolling = 0;
+    std::uint64_t power = (size > 0) ? NGramTable::leaving_power(size) : 1;
+
+    std::map<int, NGramTable> grams;
+    if (size > 0)
+    {
+        grams.emplace(size, NGramTable(size));
+    }
+
+    try
+    {
+        std::string lower_case;
+
+        auto add_word = [&](std::string_view word) {
+            std::uint32_t id = this->intern_word(symbols, word, false, lower_case);
+
+            if (id >= counts.size())
+            {
+                counts.resize(id + 1, 0);
+            }
+
+            ++counts[id];
+
+            if (size > 0 && !read_filter.contains(id))
+            {
+                if (window_end == window.size())
+                {
+                    // Keeps the whole last window, so the word leaving it is still in the buffer
+                    std::copy(window.end() - size, window.end(), window.begin());
+                    window_end = size;
+                }
+
+                window[window_end++] = id;
+                ++window_words;
+
+                if (window_words >= static_cast<std::size_t>(size))
+                {
+                    const std::uint32_t *gram = window.data() + window_end - size;
+
+                    // The first full window is hashed whole, every following one only moves the hash
+                    rolling = (window_words == static_cast<std::size_t>(size)) ? NGramTable::hash(gram, size) : NGramTable::roll(rolling, gram[-1], id, power);
+
+                    grams.at(size).add(gram, rolling, 1);
+                }
+            }
+        };
+
+        // Only a single chunk and the unfinished word are kept in memory
+        std::ifstream file(this->file_path, std::ios::binary);
+        std::vector<char> chunk(STREAM_CHUNK_SIZE);
+        Tokenizer::Stream stream;
+
+        while (file.read(chunk.data(), chunk.size()) || file.gcount() > 0)
+        {
+            stream.feed(chunk.data(), file.gcount(), add_word);
+        }
+
+        stream.finish(add_word);
+    }
+    catch (const std::exception &e)
+    {
+        // Error during reading of a single file is not fatal error
+        std::cerr << "File " + this->file_path + " could not be parsed due to an error!" + e.what() + "\n";
+    }
+
+    this->frequencies = WordCountTable(counts);
+    this->streamed_n_grams = std::move(grams);
+}
+
+std::uint32_t Statistics::intern_word(SymbolTable &symbols, std::string_view word, bool is_folded, std::string &lower_case)
+{
+    // Tokenizer already knows most words which are not changed by folding
+    if (this->case_sensitive && !is_folded)
+    {
+        // Folds case of every character, words which are already folded are interned without copying
+        word = CaseFolding::fold(word, lower_case);
+    }
+
+    return symbols.intern(word);
+}
+
+void Statistics::resolve_filter()
+{
+    this->filter = FilterSet::resolve(this->filter_words, *this->symbols, this->case_sensitive);
+}
+
 void Statistics::set_filter(std::vector<std::wstring> filter)
 {
-    this->filter = filter;
+    this->filter_words = filter;
+    this->resolve_filter();
+    this->clear_results();
+}
+
+void Statistics::clear_results()
+{
+    this->filtered_words.reset();
+    this->filtered_frequencies.reset();
+    this->word_count.reset();
+    this->n_gram_tables.clear();
+}
+
+void Statistics::set_stamping()
+{
+    this->stamping = true;
+}
+
+CorpusIndex::file_stamp Statistics::get_file_stamp()
+{
+    return this->stamp;
+}
+
+void Statistics::set_file_stamp(CorpusIndex::file_stamp stamp)
+{
+    this->stamp = stamp;
 }
 
 std::string Statistics::get_file_path()
@@ -175,7 +451,66 @@ std::string Statistics::get_file_path()
     return this->file_path;
 }
 
+void Statistics::set_streaming(int n_gram_size)
+{
+    this->streaming = true;
+    this->streamed_n_gram_size = n_gram_size;
+}
+
 void Statistics::load()
 {
-    this->words = this->parse_file();
-}
\ No newline at end of file
+    // Results of a previous load are not valid for the new words
+    this->clear_results();
+
+    if (this->index)
+    {
+        // Word IDs already point into the shared symbol table, only the counts are read
+        this->frequencies = this->index->get_frequencies(this->index_file);
+        return;
+    }
+
+    auto symbols = std::make_shared<SymbolTable>();
+
+    if (this->streaming)
+    {
+        this->stream_file(*symbols);
+    }
+    else
+    {
+        this->words = this->parse_file(*symbols);
+
+        // Builds the frequency table once, every count is then answered from it
+        this->frequencies = WordCountTable(this->words, symbols->size());
+    }
+
+    this->symbols = symbols;
+
+    this->resolve_filter();
+}
+
+void Statistics::load(std::string_view content)
+{
+    if (this->streaming || this->index)
+    {
+        throw std::logic_error("File " + this->file_path + " is not loaded from its whole content!");
+    }
+
+    this->clear_results();
+
+    auto symbols = std::make_shared<SymbolTable>();
+
+    try
+    {
+        this->words = this->parse_content(*symbols, content);
+    }
+    catch (const std::exception &e)
+    {
+        // Same as in parse_file, a single file which cannot be parsed is not fatal
+        std::cerr << "File " + this->file_path + " could not be parsed due to an error!" + e.what() + "\n";
+    }
+
+    this->frequencies = WordCountTable(this->words, symbols->size());
+    this->symbols = symbols;
+
+    this->resolve_filter();
+}
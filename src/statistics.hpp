@@ -1,3 +1,16 @@
+#pragma once
+
+#include "corpus_index.hpp"
+#include "filter_set.hpp"
+#include "n_gram_table.hpp"
+#include "symbol_table.hpp"
+#include "word_count_table.hpp"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string_view>
 #include <vector>
 #include <string>
 
@@ -7,11 +20,6 @@
 class Statistics
 {
 private:
-    std::vector<std::wstring> words;
-    std::vector<std::wstring> filter;
-    std::string file_path;
-    bool case_sensitive;
-
 public:
     // Simple struct to get rid of long lines with std::pair
     struct n_gram
@@ -20,6 +28,55 @@ public:
         long count;
     };
 
+    // Read only view of word IDs, which are either parsed from the file or kept inside of an index
+    struct word_span
+    {
+        const std::uint32_t *data;
+        std::size_t size;
+
+        const std::uint32_t *begin() const { return data; }
+        const std::uint32_t *end() const { return data + size; }
+    };
+
+private:
+    // Words of the file as IDs into the symbol table
+    std::vector<std::uint32_t> words;
+
+    // Index holding the words of the file instead of the vector, if the file was loaded from one
+    std::shared_ptr<const CorpusIndex> index;
+    std::size_t index_file = 0;
+
+    // Size, modification time and content hash of the file when it was loaded, computed only if stamping is on
+    bool stamping = false;
+    CorpusIndex::file_stamp stamp{};
+
+    // Table with the text of the words, shared by every Statistics of an Analyzer
+    std::shared_ptr<SymbolTable> symbols;
+
+    // Filtered out words and their IDs, IDs are resolved whenever the symbol table changes
+    std::vector<std::wstring> filter_words;
+    FilterSet filter;
+
+    // Number of occurrences of each distinct word, built once when the file is loaded
+    WordCountTable frequencies;
+    std::string file_path;
+    bool case_sensitive;
+
+    // In streaming mode only counts are kept, words and n-grams are counted while the file is read
+    bool streaming = false;
+    int streamed_n_gram_size = 0;
+    std::map<int, NGramTable> streamed_n_grams;
+
+    // Words and counts without the filtered out words, made by a single pass once per filter
+    // Every query reads them instead of checking the filter again, without a filter the raw ones are used
+    std::optional<std::vector<std::uint32_t>> filtered_words;
+    std::optional<WordCountTable> filtered_frequencies;
+
+    // Results are computed on the first request and kept until the filter or the words change
+    std::optional<long> word_count;
+    std::map<int, NGramTable> n_gram_tables;
+
+public:
     /**
      * @brief  Creates Statistics for a file.
      * 
@@ -37,11 +94,22 @@ public:
      */
     Statistics(std::string file_path, std::vector<std::wstring> filter, bool case_sensitive);
 
+    /**
+     * @brief  Creates Statistics for a file stored in an index.
+     * @note   Words are used in place from the index, nothing is tokenized.
+     * 
+     * @param  index    Loaded index
+     * @param  file     Index of the file inside of the index
+     * @param  symbols  Symbol table loaded from the index
+     * @param  filter   Vector of words to filter out
+     */
+    Statistics(std::shared_ptr<const CorpusIndex> index, std::size_t file, std::shared_ptr<SymbolTable> symbols, std::vector<std::wstring> filter);
+
     ~Statistics() = default;
 
     /**
      * @brief  Counts every word inside the file.
-     * @note   Discards any filtered out words.
+     * @note   Discards any filtered out words. Counted once, until the filter changes.
      * 
      * @retval Number of words in the file
      */
@@ -49,7 +117,7 @@ public:
 
     /**
      * @brief  Counts every unique word inside the file.
-     * @note   Discards any filtered out words.
+     * @note   Discards any filtered out words. Counted once, until the filter changes.
      * 
      * @retval Number of unique words in the file
      */
@@ -57,21 +125,95 @@ public:
 
     /**
      * @brief  Returns the vector of words inside the file.
-     * @note   Includes the "filtered out" words.
+     * @note   Includes the "filtered out" words. Words are converted from IDs into text.
+     * @note   Throws in streaming mode, words are not kept.
      * 
      * @retval Every word from the file
      */
     std::vector<std::wstring> get_words();
 
     /**
-     * @brief Returns the vector of n-grams inside the file. 
-     * The vector is ordered by count in descending order.
+     * @brief  Returns the vector of word IDs inside the file.
+     * @note   Includes the "filtered out" words.
+     * 
+     * @retval Every word from the file as an ID into the symbol table, empty in streaming mode
+     */
+    Statistics::word_span get_word_ids();
+
+    /**
+     * @brief  Returns the number of occurrences of each distinct word inside the file.
+     * @note   Includes the "filtered out" words.
+     * 
+     * @retval Table of word IDs with their number of occurrences
+     */
+    const WordCountTable &get_word_frequencies();
+
+    /**
+     * @brief  Returns the word IDs inside the file without the filtered out words.
+     * @note   Words are filtered by a single pass, once per filter. Without a filter the same as get_word_ids.
+     * 
+     * @retval Words of the file which are not filtered out, empty in streaming mode
+     */
+    Statistics::word_span get_filtered_word_ids();
+
+    /**
+     * @brief  Returns the number of occurrences of each distinct word inside the file without the filtered out words.
+     * @note   Filtered once per filter. Without a filter the same as get_word_frequencies.
+     * 
+     * @retval Table of word IDs with their number of occurrences
+     */
+    const WordCountTable &get_filtered_frequencies();
+
+    /**
+     * @brief  Returns the symbol table holding the text of the word IDs.
+     * 
+     * @retval Symbol table of the file, shared by the Analyzer after loading
+     */
+    const SymbolTable &get_symbols();
+
+    /**
+     * @brief  Moves the words into a shared symbol table and remaps all IDs to it.
+     * @note   Has to be called after the file is loaded. Only one thread may use the table at a time.
+     * 
+     * @param  symbols  Symbol table shared with other Statistics
+     */
+    void share_symbols(std::shared_ptr<SymbolTable> symbols);
+
+    /**
+     * @brief  Counts every n-gram inside the file.
+     * @note   N-grams are formed from the words which are not filtered out, as if the filtered words were removed from the text.
+     * @note   Throws in streaming mode if n-grams of the size were not counted while reading.
+     * Streamed n-grams leave out the words filtered when the file was loaded, a later filter does not change them.
+     * 
+     * @param  size Size of the n-gram. Has to be at least 1
+     * 
+     * @retval Table of n-grams as word IDs with their counts
+     */
+    NGramTable count_n_grams(int size);
+
+    /**
+     * @brief Returns the vector of the most frequent n-grams inside the file. 
+     * The vector is ordered by count in descending order, n-grams with equal count are ordered by text.
+     * @note  N-grams of each size are counted once and kept for later requests.
+     * 
+     * @param size  Size of the n-gram. Has to be at least 1
+     * @param count Maximum number of returned n-grams
+     * 
+     * @return std::vector<n_gram> Most frequent n-grams in the file
+     */
+    std::vector<Statistics::n_gram> get_n_grams(int size, std::size_t count);
+
+    /**
+     * @brief Returns the vector of the most frequent n-grams inside the file without keeping their table.
+     * @note  Uses the kept table if there is one, otherwise counts the n-grams and drops the table afterwards.
+     * Used when the n-grams of many files are written one after another, so the tables of all files are never kept at once.
      * 
-     * @param size Size of the n-gram. Has to be at least 1
+     * @param size  Size of the n-gram. Has to be at least 1
+     * @param count Maximum number of returned n-grams
      * 
-     * @return std::vector<n_gram> All n-grams in the file
+     * @return std::vector<n_gram> Most frequent n-grams in the file
      */
-    std::vector<Statistics::n_gram> get_n_grams(int size);
+    std::vector<Statistics::n_gram> find_n_grams(int size, std::size_t count);
 
     /**
      * @brief  Sets the filter vector for statistics.
@@ -80,6 +222,36 @@ public:
      */
     void set_filter(std::vector<std::wstring> filter);
 
+    /**
+     * @brief  Switches loading into streaming mode. Has to be called before the file is loaded.
+     * @note   File is read in chunks of fixed size and only counts are kept, never the whole text or all of the words.
+     * Memory is then bounded by the size of vocabulary, not the size of the file.
+     * 
+     * @param  n_gram_size  Size of n-grams counted while reading, no n-grams are counted if less than 1
+     */
+    void set_streaming(int n_gram_size);
+
+    /**
+     * @brief  Turns on computing the state of the file while it is loaded. Has to be called before the file is loaded.
+     * @note   Reading the content hash takes an extra pass over the file.
+     */
+    void set_stamping();
+
+    /**
+     * @brief  Returns the state of the file when it was loaded.
+     * @note   Empty if stamping is off or in streaming mode.
+     * 
+     * @retval Size, modification time and content hash of the file
+     */
+    CorpusIndex::file_stamp get_file_stamp();
+
+    /**
+     * @brief  Replaces the state of the file, for example when a file from an index was only touched.
+     * 
+     * @param  stamp    Size, modification time and content hash of the file
+     */
+    void set_file_stamp(CorpusIndex::file_stamp stamp);
+
     /**
      * @brief  Returns the file path.
      * 
@@ -89,15 +261,86 @@ public:
 
     /**
      * @brief  Loads the contents of the file.
+     * @note   Words are stored in a symbol table private to the Statistics until share_symbols is called.
+     * Files from an index only read their word counts, the filter is set afterwards by set_filter.
      */
     void load();
 
+    /**
+     * @brief  Loads the contents of the file which were already read, for example by a reader of a pipeline.
+     * @note   Throws in streaming mode and for files from an index, they are not tokenized at once.
+     * 
+     * @param  content  Whole content of the file
+     */
+    void load(std::string_view content);
+
 private:
     /**
-     * @brief  Parses the file contents into a vector of wide strings.
+     * @brief  Parses the file contents into a vector of word IDs.
      * @note   Throws on file not being readable
      * 
-     * @retval Vector of all words in the file
+     * @param  symbols  Symbol table receiving the words
+     * 
+     * @retval Vector of all words in the file as IDs
+     */
+    std::vector<std::uint32_t> parse_file(SymbolTable &symbols);
+
+    /**
+     * @brief  Splits the file contents into words and adds them into a symbol table.
+     * 
+     * @param  symbols  Symbol table receiving the words
+     * @param  content  Whole content of the file
+     * 
+     * @retval Vector of all words in the file as IDs
+     */
+    std::vector<std::uint32_t> parse_content(SymbolTable &symbols, std::string_view content);
+
+    /**
+     * @brief  Reads the file in chunks and counts words and n-grams without keeping them.
+     * @note   Throws on file not being readable
+     * 
+     * @param  symbols  Symbol table receiving the words
+     */
+    void stream_file(SymbolTable &symbols);
+
+    /**
+     * @brief  Adds a word into the symbol table, folding its case if case is ignored.
+     * 
+     * @param  symbols      Symbol table receiving the word
+     * @param  word         UTF-8 encoded word
+     * @param  is_folded    Is the word known to be unchanged by folding?
+     * @param  lower_case   Buffer for the folded word, reused between words to avoid allocations
+     * 
+     * @retval ID of the word
+     */
+    std::uint32_t intern_word(SymbolTable &symbols, std::string_view word, bool is_folded, std::string &lower_case);
+
+    /**
+     * @brief  Looks up IDs of the filtered out words in the current symbol table.
+     */
+    void resolve_filter();
+
+    /**
+     * @brief  Returns the table of n-grams of the size, counting it on the first request.
+     * 
+     * @param  size Size of the n-gram. Has to be at least 1
+     * 
+     * @retval Table of n-grams as word IDs with their counts
+     */
+    const NGramTable &get_n_gram_table(int size);
+
+    /**
+     * @brief  Converts the most frequent n-grams of a table into text.
+     * 
+     * @param  grams    Counted n-grams of the file
+     * @param  count    Maximum number of returned n-grams
+     * 
+     * @retval Most frequent n-grams in descending order by count
+     */
+    std::vector<Statistics::n_gram> select_n_grams(const NGramTable &grams, std::size_t count);
+
+    /**
+     * @brief  Drops every computed result, they are computed again on the next request.
      */
-    std::vector<std::wstring> parse_file();
+    void clear_results();
 };
\ No newline at end of file
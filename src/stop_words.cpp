@@ -0,0 +1,13 @@
+#include "stop_words.hpp"
+
+#include <stdexcept>
+
+std::vector<std::wstring> StopWords::get(const std::string &language)
+{
+    if (language == "english")
+    {
+        return std::vector<std::wstring>(StopWords::ENGLISH.begin(), StopWords::ENGLISH.end());
+    }
+
+    throw std::invalid_argument("There is no built-in list of stop words for \"" + language + "\".");
+}
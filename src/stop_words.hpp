@@ -0,0 +1,33 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace StopWords
+{
+    // Most common English words, the same list as ./examples/filter/stop_words_english.txt
+    constexpr std::array<std::wstring_view, 127> ENGLISH = {
+        L"i", L"me", L"my", L"myself", L"we", L"our", L"ours", L"ourselves", L"you", L"your", L"yours", L"yourself",
+        L"yourselves", L"he", L"him", L"his", L"himself", L"she", L"her", L"hers", L"herself", L"it", L"its",
+        L"itself", L"they", L"them", L"their", L"theirs", L"themselves", L"what", L"which", L"who", L"whom", L"this",
+        L"that", L"these", L"those", L"am", L"is", L"are", L"was", L"were", L"be", L"been", L"being", L"have", L"has",
+        L"had", L"having", L"do", L"does", L"did", L"doing", L"a", L"an", L"the", L"and", L"but", L"if", L"or",
+        L"because", L"as", L"until", L"while", L"of", L"at", L"by", L"for", L"with", L"about", L"against", L"between",
+        L"into", L"through", L"during", L"before", L"after", L"above", L"below", L"to", L"from", L"up", L"down", L"in",
+        L"out", L"on", L"off", L"over", L"under", L"again", L"further", L"then", L"once", L"here", L"there", L"when",
+        L"where", L"why", L"how", L"all", L"any", L"both", L"each", L"few", L"more", L"most", L"other", L"some",
+        L"such", L"no", L"nor", L"not", L"only", L"own", L"same", L"so", L"than", L"too", L"very", L"s", L"t", L"can",
+        L"will", L"just", L"don", L"should", L"now"};
+
+    /**
+     * @brief Returns a built-in list of stop words.
+     * @note  Throws if there is no list for the language.
+     *
+     * @param language Name of the language, for example "english"
+     *
+     * @return std::vector<std::wstring> Stop words of the language
+     */
+    std::vector<std::wstring> get(const std::string &language);
+}; // namespace StopWords
@@ -0,0 +1,160 @@
+#include "symbol_table.hpp"
+#include "utf8.hpp"
+
+#include <functional>
+#include <stdexcept>
+
+namespace
+{
+    // Index starts with 2^MIN_SLOT_BITS slots
+    const unsigned int MIN_SLOT_BITS = 4;
+
+    // Hash of the bytes of a word, the same for copies and external words
+    std::size_t hash_word(std::string_view word)
+    {
+        return std::hash<std::string_view>()(word);
+    }
+
+    /**
+     * @brief Spreads the hash, so its top bits can be used as a slot index.
+     */
+    std::uint64_t finalize(std::size_t hash)
+    {
+        return static_cast<std::uint64_t>(hash) * 0x9E3779B97F4A7C15ULL;
+    }
+}; // namespace
+
+std::uint32_t SymbolTable::intern(std::string_view word)
+{
+    this->index_words();
+
+    std::size_t hash = hash_word(word);
+    if (!this->slots.empty())
+    {
+        std::size_t slot = this->find_slot(word, hash);
+        if (this->slots[slot] != NOT_FOUND)
+        {
+            return this->slots[slot];
+        }
+    }
+
+    if (this->words.size() >= NOT_FOUND)
+    {
+        throw std::length_error("Symbol table cannot hold more distinct words!");
+    }
+
+    std::uint32_t id = this->words.size();
+    this->words.push_back(this->storage.store(word));
+    this->insert(id, hash);
+    this->indexed_count = this->words.size();
+
+    return id;
+}
+
+std::uint32_t SymbolTable::find(std::string_view word) const
+{
+    this->index_words();
+
+    if (this->slots.empty())
+    {
+        return NOT_FOUND;
+    }
+
+    return this->slots[this->find_slot(word, hash_word(word))];
+}
+
+std::uint32_t SymbolTable::add_external(std::string_view word)
+{
+    if (this->words.size() >= NOT_FOUND)
+    {
+        throw std::length_error("Symbol table cannot hold more distinct words!");
+    }
+
+    this->words.push_back(word);
+
+    return this->words.size() - 1;
+}
+
+void SymbolTable::index_words() const
+{
+    if (this->indexed_count == this->words.size())
+    {
+        return;
+    }
+
+    this->hashes.reserve(this->words.size());
+
+    for (; this->indexed_count < this->words.size(); ++this->indexed_count)
+    {
+        this->insert(this->indexed_count, hash_word(this->words[this->indexed_count]));
+    }
+}
+
+std::size_t SymbolTable::find_slot(std::string_view word, std::size_t hash) const
+{
+    std::size_t mask = this->slots.size() - 1;
+    std::size_t slot = finalize(hash) >> (64 - this->slot_bits);
+
+    // Words are compared only when their hashes match
+    while (this->slots[slot] != NOT_FOUND)
+    {
+        std::uint32_t id = this->slots[slot];
+        if (this->hashes[id] == hash && this->words[id] == word)
+        {
+            break;
+        }
+
+        slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+
+void SymbolTable::insert(std::uint32_t id, std::size_t hash) const
+{
+    this->hashes.push_back(hash);
+
+    // Keeps the load factor at most 1/2, so probe sequences stay short
+    if (this->hashes.size() * 2 <= this->slots.size())
+    {
+        this->place(id);
+        return;
+    }
+
+    this->slot_bits = (this->slots.empty()) ? MIN_SLOT_BITS : this->slot_bits + 1;
+    this->slots.assign(std::size_t(1) << this->slot_bits, NOT_FOUND);
+
+    for (std::uint32_t indexed = 0; indexed < this->hashes.size(); ++indexed)
+    {
+        this->place(indexed);
+    }
+}
+
+void SymbolTable::place(std::uint32_t id) const
+{
+    std::size_t mask = this->slots.size() - 1;
+    std::size_t slot = finalize(this->hashes[id]) >> (64 - this->slot_bits);
+
+    // Every word is distinct, so only an empty slot has to be found
+    while (this->slots[slot] != NOT_FOUND)
+    {
+        slot = (slot + 1) & mask;
+    }
+
+    this->slots[slot] = id;
+}
+
+std::string_view SymbolTable::get(std::uint32_t id) const
+{
+    return this->words.at(id);
+}
+
+std::wstring SymbolTable::get_wstring(std::uint32_t id) const
+{
+    return UTF8::decode(this->words.at(id));
+}
+
+std::size_t SymbolTable::size() const
+{
+    return this->words.size();
+}
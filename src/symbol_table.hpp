@@ -0,0 +1,119 @@
+#pragma once
+
+#include "arena.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Table of distinct words, each of them identified by a 32 bit ID.
+ * @note  Words are stored only once as UTF-8 encoded bytes, IDs are assigned in order of insertion.
+ * Bytes of the words are kept back to back in an arena and IDs are found through a flat open addressing index,
+ * so adding a word allocates nothing except when the arena or the index grows.
+ */
+class SymbolTable
+{
+public:
+    // ID returned for words which are not in the table
+    static constexpr std::uint32_t NOT_FOUND = UINT32_MAX;
+
+private:
+    // Bytes of the added words, released all at once with the table
+    Arena storage;
+
+    // Every word by its ID, either in the storage or in memory owned by someone else
+    std::vector<std::string_view> words;
+
+    // Open addressing with linear probing, empty slots hold NOT_FOUND, otherwise ID of the word
+    // Hashes of the words are kept, so growing the index never hashes a word again
+    mutable std::vector<std::uint32_t> slots;
+    mutable std::vector<std::size_t> hashes;
+    mutable unsigned int slot_bits = 0;
+
+    // Words which were added without copying are indexed by the first lookup
+    mutable std::size_t indexed_count = 0;
+
+    /**
+     * @brief Adds every word which is not indexed yet into the index.
+     */
+    void index_words() const;
+
+    /**
+     * @brief Finds the slot holding the word or the empty slot where it belongs.
+     */
+    std::size_t find_slot(std::string_view word, std::size_t hash) const;
+
+    /**
+     * @brief Inserts the word with the ID into an empty slot, growing the index if needed.
+     */
+    void insert(std::uint32_t id, std::size_t hash) const;
+
+    /**
+     * @brief Puts an indexed word into the first empty slot of its probe sequence.
+     */
+    void place(std::uint32_t id) const;
+
+public:
+    SymbolTable() = default;
+
+    // Words point into the arena, copying would leave them dangling
+    SymbolTable(const SymbolTable &) = delete;
+    SymbolTable &operator=(const SymbolTable &) = delete;
+
+    /**
+     * @brief Returns the ID of a word, adding the word if it is not in the table yet.
+     *
+     * @param word UTF-8 encoded word
+     *
+     * @return std::uint32_t ID of the word
+     */
+    std::uint32_t intern(std::string_view word);
+
+    /**
+     * @brief Finds the ID of a word without adding it.
+     *
+     * @param word UTF-8 encoded word
+     *
+     * @return std::uint32_t ID of the word or SymbolTable::NOT_FOUND
+     */
+    std::uint32_t find(std::string_view word) const;
+
+    /**
+     * @brief Adds a word without copying it.
+     * @note  The word must not be in the table yet and its bytes have to outlive the table.
+     * Lookups of the word are possible after the next find() or intern().
+     *
+     * @param word UTF-8 encoded word
+     *
+     * @return std::uint32_t ID of the word
+     */
+    std::uint32_t add_external(std::string_view word);
+
+    /**
+     * @brief Returns the word with the ID.
+     *
+     * @param id ID of the word
+     *
+     * @return std::string_view UTF-8 encoded word
+     */
+    std::string_view get(std::uint32_t id) const;
+
+    /**
+     * @brief Returns the word with the ID decoded into a wide string.
+     *
+     * @param id ID of the word
+     *
+     * @return std::wstring Decoded word
+     */
+    std::wstring get_wstring(std::uint32_t id) const;
+
+    /**
+     * @brief Returns the number of distinct words in the table.
+     *
+     * @return std::size_t Number of words
+     */
+    std::size_t size() const;
+};
@@ -0,0 +1,184 @@
+#include "thread_pool.hpp"
+
+namespace
+{
+    // Pool and queue index of the current thread, used to keep subtasks on the submitting worker
+    thread_local ThreadPool *current_pool = nullptr;
+    thread_local std::size_t current_queue = 0;
+}; // namespace
+
+ThreadPool::ThreadPool(unsigned int threads)
+{
+    if (threads == 0)
+    {
+        threads = ThreadPool::default_threads();
+    }
+
+    for (unsigned int i = 0; i < threads; ++i)
+    {
+        this->queues.push_back(std::make_unique<Queue>());
+    }
+
+    for (unsigned int i = 0; i < threads; ++i)
+    {
+        this->workers.emplace_back(&ThreadPool::run, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::unique_lock<std::mutex> lock(this->state_mutex);
+        this->tasks_finished.wait(lock, [this] { return this->pending == 0; });
+        this->stopping = true;
+    }
+
+    this->task_available.notify_all();
+
+    for (auto &worker : this->workers)
+    {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    std::size_t index;
+
+    {
+        std::lock_guard<std::mutex> lock(this->state_mutex);
+
+        if (current_pool == this)
+        {
+            index = current_queue;
+        }
+        else
+        {
+            // Tasks from outside of the pool are distributed evenly
+            index = this->next_queue;
+            this->next_queue = (this->next_queue + 1) % this->queues.size();
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->queues.at(index)->mutex);
+        this->queues.at(index)->tasks.push_back(std::move(task));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->state_mutex);
+        ++this->queued;
+        ++this->pending;
+    }
+
+    this->task_available.notify_one();
+}
+
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> lock(this->state_mutex);
+    this->tasks_finished.wait(lock, [this] { return this->pending == 0; });
+
+    if (this->error)
+    {
+        std::exception_ptr error = this->error;
+        this->error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+unsigned int ThreadPool::size()
+{
+    return this->workers.size();
+}
+
+unsigned int ThreadPool::default_threads()
+{
+    // hardware_concurrency may return 0 if the value is not computable
+    unsigned int threads = std::thread::hardware_concurrency();
+    return (threads == 0) ? 1 : threads;
+}
+
+void ThreadPool::run(std::size_t index)
+{
+    current_pool = this;
+    current_queue = index;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(this->state_mutex);
+            this->task_available.wait(lock, [this] { return this->stopping || this->queued > 0; });
+
+            if (this->queued == 0)
+            {
+                // Only reachable when stopping and every task was taken
+                return;
+            }
+
+            // Claims one of the queued tasks, it is guaranteed to be in one of the queues
+            --this->queued;
+        }
+
+        std::function<void()> task;
+        while (!this->take(index, task))
+        {
+            std::this_thread::yield();
+        }
+
+        try
+        {
+            task();
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(this->state_mutex);
+            if (!this->error)
+            {
+                this->error = std::current_exception();
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(this->state_mutex);
+            --this->pending;
+
+            if (this->pending == 0)
+            {
+                this->tasks_finished.notify_all();
+            }
+        }
+    }
+}
+
+bool ThreadPool::take(std::size_t index, std::function<void()> &task)
+{
+    // Own queue is used as a stack to keep recently submitted data in cache
+    {
+        Queue &own = *this->queues.at(index);
+        std::lock_guard<std::mutex> lock(own.mutex);
+
+        if (!own.tasks.empty())
+        {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+
+    // Steals the oldest task of another worker
+    for (std::size_t offset = 1; offset < this->queues.size(); ++offset)
+    {
+        Queue &other = *this->queues.at((index + offset) % this->queues.size());
+        std::lock_guard<std::mutex> lock(other.mutex);
+
+        if (!other.tasks.empty())
+        {
+            task = std::move(other.tasks.front());
+            other.tasks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
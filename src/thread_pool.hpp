@@ -0,0 +1,136 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Work stealing pool of worker threads.
+ * @note  Every worker owns a queue of tasks. Workers take their own tasks from the back
+ * and steal tasks of other workers from the front once their queue is empty.
+ */
+class ThreadPool
+{
+private:
+    // Queue of tasks owned by a single worker
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+
+    // Guards the counters below, workers sleep on task_available
+    std::mutex state_mutex;
+    std::condition_variable task_available;
+    std::condition_variable tasks_finished;
+
+    // Tasks waiting in queues which were not claimed by a worker yet
+    std::size_t queued = 0;
+    // Tasks submitted but not finished
+    std::size_t pending = 0;
+    // Queue that receives the next task submitted from outside of the pool
+    std::size_t next_queue = 0;
+    bool stopping = false;
+
+    // First exception thrown by a task, rethrown by wait()
+    std::exception_ptr error;
+
+public:
+    /**
+     * @brief Starts the worker threads.
+     *
+     * @param threads Number of workers, 0 uses the number of hardware threads
+     */
+    explicit ThreadPool(unsigned int threads);
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /**
+     * @brief Finishes all submitted tasks and stops the workers.
+     */
+    ~ThreadPool();
+
+    /**
+     * @brief Submits a task for execution.
+     * @note  Tasks submitted from a worker are pushed to the queue of that worker.
+     *
+     * @param task Task to be executed
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * @brief Blocks until every submitted task is finished.
+     * @note  Rethrows the first exception thrown by a task. Must not be called from a worker.
+     */
+    void wait();
+
+    /**
+     * @brief Combines items into one by merging pairs of them in parallel.
+     * @note  Items are merged as a balanced tree, so only log2(n) rounds are needed.
+     * The order of merges is fixed, the result does not depend on the number of threads.
+     * Must not be called from a worker.
+     *
+     * @param items Items to be combined, must not be empty
+     * @param merge Called as merge(T &target, T &source), adds the source into the target
+     *
+     * @return T Combination of all items
+     */
+    template <typename T, typename Merge>
+    T reduce(std::vector<T> items, Merge merge)
+    {
+        for (std::size_t stride = 1; stride < items.size(); stride *= 2)
+        {
+            // Pairs in a single round are independent of each other
+            for (std::size_t i = 0; i + stride < items.size(); i += 2 * stride)
+            {
+                this->submit([&items, &merge, i, stride] { merge(items[i], items[i + stride]); });
+            }
+
+            this->wait();
+        }
+
+        return std::move(items.front());
+    }
+
+    /**
+     * @brief Returns the number of worker threads.
+     *
+     * @retval Number of workers
+     */
+    unsigned int size();
+
+    /**
+     * @brief Returns the number of threads used when no count is set.
+     *
+     * @retval Number of hardware threads, at least 1
+     */
+    static unsigned int default_threads();
+
+private:
+    /**
+     * @brief Main loop of a worker thread.
+     *
+     * @param index Index of the queue owned by the worker
+     */
+    void run(std::size_t index);
+
+    /**
+     * @brief Takes a task from the own queue or steals one from another worker.
+     *
+     * @param index Index of the queue owned by the worker
+     * @param task  Taken task
+     *
+     * @retval Was a task found?
+     */
+    bool take(std::size_t index, std::function<void()> &task);
+};
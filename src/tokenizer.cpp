@@ -0,0 +1,251 @@
+#include "tokenizer.hpp"
+
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#define TEXTANALYSIS_SSE2
+#include <emmintrin.h>
+#endif
+
+// AVX2 is compiled only for the single function, the rest of the program runs on any x86 processor
+#if defined(TEXTANALYSIS_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define TEXTANALYSIS_AVX2
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    // Number of bytes which are not a part of a word, every delimiter and the punctuation lead byte
+    constexpr std::size_t SPECIAL_COUNT = Delimiters::ASCII_DELIMITERS.size() + 1;
+
+    /**
+     * @brief Lists the bytes which are not a part of a word.
+     */
+    constexpr std::array<unsigned char, SPECIAL_COUNT> build_special_bytes()
+    {
+        std::array<unsigned char, SPECIAL_COUNT> bytes{};
+
+        std::size_t count = 0;
+        for (int byte = 0; byte < 256; ++byte)
+        {
+            if (Delimiters::byte_classes[byte] != Delimiters::WORD)
+            {
+                bytes[count++] = static_cast<unsigned char>(byte);
+            }
+        }
+
+        return bytes;
+    }
+
+    inline constexpr std::array<unsigned char, SPECIAL_COUNT> special_bytes = build_special_bytes();
+
+    // Tables of a nibble lookup, a byte is special if the entries of both of its nibbles share a bit
+    // Each bit stands for a single high nibble, so the lookup is exact for up to 8 different high nibbles
+    struct nibble_tables
+    {
+        std::array<std::uint8_t, 16> low;
+        std::array<std::uint8_t, 16> high;
+    };
+
+    /**
+     * @brief Builds the nibble lookup tables of the special bytes.
+     */
+    constexpr nibble_tables build_nibble_tables()
+    {
+        nibble_tables tables{};
+
+        int bits = 0;
+        for (auto byte : special_bytes)
+        {
+            int high = byte >> 4;
+
+            if (tables.high[high] == 0)
+            {
+                tables.high[high] = static_cast<std::uint8_t>(1 << bits++);
+            }
+
+            tables.low[byte & 0x0F] |= tables.high[high];
+        }
+
+        return tables;
+    }
+
+    inline constexpr nibble_tables NIBBLE_TABLES = build_nibble_tables();
+
+    /**
+     * @brief Checks that the nibble lookup finds exactly the special bytes.
+     */
+    constexpr bool is_nibble_lookup_exact()
+    {
+        for (int byte = 0; byte < 256; ++byte)
+        {
+            bool special = (NIBBLE_TABLES.low[byte & 0x0F] & NIBBLE_TABLES.high[byte >> 4]) != 0;
+            if (special != (Delimiters::byte_classes[byte] != Delimiters::WORD))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    static_assert(is_nibble_lookup_exact(), "Delimiters have too many different high nibbles for the nibble lookup");
+
+    // Upper case ASCII letters in signed bytes after subtracting 'A' + 128, used by the vector kernels
+    const char UPPER_OFFSET = static_cast<char>('A' + 128);
+    const char UPPER_LIMIT = static_cast<char>(26 - 128);
+
+    Delimiters::block_masks classify_scalar(const unsigned char *block)
+    {
+        Delimiters::block_masks masks{0, 0};
+
+        for (std::size_t i = 0; i < Delimiters::BLOCK_SIZE; ++i)
+        {
+            unsigned char byte = block[i];
+
+            masks.delimiters |= std::uint64_t(Delimiters::byte_classes[byte] != Delimiters::WORD) << i;
+            masks.foldable |= std::uint64_t(byte >= 0x80 || (byte >= 'A' && byte <= 'Z')) << i;
+        }
+
+        return masks;
+    }
+
+#ifdef TEXTANALYSIS_SSE2
+    Delimiters::block_masks classify_sse2(const unsigned char *block)
+    {
+        Delimiters::block_masks masks{0, 0};
+
+        // SSE2 has no byte shuffle, every special byte is compared separately
+        for (std::size_t offset = 0; offset < Delimiters::BLOCK_SIZE; offset += 16)
+        {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + offset));
+            __m128i matches = _mm_setzero_si128();
+
+            for (auto byte : special_bytes)
+            {
+                matches = _mm_or_si128(matches, _mm_cmpeq_epi8(chunk, _mm_set1_epi8(static_cast<char>(byte))));
+            }
+
+            // Bytes of multi-byte characters have the high bit set, which is what the byte mask collects
+            __m128i upper = _mm_cmplt_epi8(_mm_sub_epi8(chunk, _mm_set1_epi8(UPPER_OFFSET)), _mm_set1_epi8(UPPER_LIMIT));
+
+            masks.delimiters |= std::uint64_t(static_cast<std::uint32_t>(_mm_movemask_epi8(matches))) << offset;
+            masks.foldable |= std::uint64_t(static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_or_si128(upper, chunk)))) << offset;
+        }
+
+        return masks;
+    }
+#endif
+
+#ifdef TEXTANALYSIS_AVX2
+    __attribute__((target("avx2"))) Delimiters::block_masks classify_avx2(const unsigned char *block)
+    {
+        const __m256i low_table = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(NIBBLE_TABLES.low.data())));
+        const __m256i high_table = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(NIBBLE_TABLES.high.data())));
+        const __m256i nibble = _mm256_set1_epi8(0x0F);
+
+        Delimiters::block_masks masks{0, 0};
+
+        // Both nibbles of every byte are looked up by a shuffle, 32 bytes at a time
+        for (std::size_t offset = 0; offset < Delimiters::BLOCK_SIZE; offset += 32)
+        {
+            __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + offset));
+
+            __m256i low = _mm256_shuffle_epi8(low_table, _mm256_and_si256(chunk, nibble));
+            __m256i high = _mm256_shuffle_epi8(high_table, _mm256_and_si256(_mm256_srli_epi16(chunk, 4), nibble));
+            __m256i words = _mm256_cmpeq_epi8(_mm256_and_si256(low, high), _mm256_setzero_si256());
+
+            __m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(UPPER_LIMIT), _mm256_sub_epi8(chunk, _mm256_set1_epi8(UPPER_OFFSET)));
+
+            masks.delimiters |= std::uint64_t(~static_cast<std::uint32_t>(_mm256_movemask_epi8(words))) << offset;
+            masks.foldable |= std::uint64_t(static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(upper, chunk)))) << offset;
+        }
+
+        return masks;
+    }
+#endif
+
+    using classify_function = Delimiters::block_masks (*)(const unsigned char *);
+
+    classify_function get_function(Delimiters::Kernel kernel)
+    {
+        switch (kernel)
+        {
+#ifdef TEXTANALYSIS_AVX2
+        case Delimiters::Kernel::AVX2:
+            return classify_avx2;
+#endif
+#ifdef TEXTANALYSIS_SSE2
+        case Delimiters::Kernel::SSE2:
+            return classify_sse2;
+#endif
+        default:
+            return classify_scalar;
+        }
+    }
+
+    /**
+     * @brief Selects the fastest kernel supported by the processor.
+     */
+    Delimiters::Kernel select_kernel()
+    {
+        for (auto kernel : {Delimiters::Kernel::AVX2, Delimiters::Kernel::SSE2})
+        {
+            if (Delimiters::is_supported(kernel))
+            {
+                return kernel;
+            }
+        }
+
+        return Delimiters::Kernel::SCALAR;
+    }
+
+    Delimiters::Kernel active_kernel = select_kernel();
+    classify_function active_function = get_function(active_kernel);
+}; // namespace
+
+Delimiters::block_masks Delimiters::classify_block(const unsigned char *block)
+{
+    return active_function(block);
+}
+
+bool Delimiters::is_supported(Delimiters::Kernel kernel)
+{
+    switch (kernel)
+    {
+    case Delimiters::Kernel::SCALAR:
+        return true;
+    case Delimiters::Kernel::SSE2:
+#ifdef TEXTANALYSIS_SSE2
+        return true;
+#else
+        return false;
+#endif
+    case Delimiters::Kernel::AVX2:
+#ifdef TEXTANALYSIS_AVX2
+        // Kernel is selected by a static initializer, which may run before the CPU detection is initialized
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+
+    return false;
+}
+
+Delimiters::Kernel Delimiters::get_kernel()
+{
+    return active_kernel;
+}
+
+void Delimiters::set_kernel(Delimiters::Kernel kernel)
+{
+    if (!Delimiters::is_supported(kernel))
+    {
+        throw std::invalid_argument("Tokenizer kernel is not supported by this processor!");
+    }
+
+    active_kernel = kernel;
+    active_function = get_function(kernel);
+}
@@ -0,0 +1,420 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace Delimiters
+{
+    // Classes of the first byte of a character
+    enum ByteClass : std::uint8_t
+    {
+        WORD = 0,
+        DELIMITER = 1,
+        // Lead byte of the three byte sequences of ” „ “ …
+        PUNCTUATION_LEAD = 2
+    };
+
+    // Single byte delimiters
+    inline constexpr std::array<unsigned char, 12> ASCII_DELIMITERS = {'.', ',', ':', ';', '!', '=', '?', '(', ')', ' ', '\n', '"'};
+
+    // Lead byte of the multi-byte delimiters
+    inline constexpr unsigned char PUNCTUATION_LEAD_BYTE = 0xE2;
+
+    /**
+     * @brief Builds the lookup table of byte classes.
+     */
+    constexpr std::array<std::uint8_t, 256> build_table()
+    {
+        std::array<std::uint8_t, 256> table{};
+
+        for (unsigned char c : ASCII_DELIMITERS)
+        {
+            table[c] = DELIMITER;
+        }
+
+        table[PUNCTUATION_LEAD_BYTE] = PUNCTUATION_LEAD;
+
+        return table;
+    }
+
+    // Class of every possible byte, computed at compile time
+    inline constexpr std::array<std::uint8_t, 256> byte_classes = build_table();
+
+    // Number of bytes classified at once
+    inline constexpr std::size_t BLOCK_SIZE = 64;
+
+    // Implementations of the block classification
+    enum class Kernel
+    {
+        SCALAR,
+        SSE2,
+        AVX2
+    };
+
+    // Bit i of a mask stands for byte i of a block
+    struct block_masks
+    {
+        // Bytes which are not Delimiters::WORD bytes and may start a delimiter
+        std::uint64_t delimiters;
+        // Upper case ASCII letters and bytes of multi-byte characters, the only bytes changed by case folding
+        std::uint64_t foldable;
+    };
+
+    /**
+     * @brief Classifies the bytes of a block.
+     * @note  Uses the fastest kernel supported by the processor, selected when the program starts.
+     *
+     * @param block Delimiters::BLOCK_SIZE bytes of text
+     *
+     * @return Delimiters::block_masks Masks of the delimiters and the bytes changed by case folding
+     */
+    Delimiters::block_masks classify_block(const unsigned char *block);
+
+    /**
+     * @brief Returns whether the kernel can be used on this processor.
+     */
+    bool is_supported(Kernel kernel);
+
+    /**
+     * @brief Returns the kernel used by classify_block.
+     */
+    Kernel get_kernel();
+
+    /**
+     * @brief Selects the kernel used by classify_block, for example to compare the kernels.
+     * @note  Throws if the kernel is not supported. Must not be called while text is being tokenized.
+     *
+     * @param kernel Supported kernel
+     */
+    void set_kernel(Kernel kernel);
+
+    /**
+     * @brief Returns the position of the lowest set bit of a non-zero mask.
+     */
+    inline int lowest_bit(std::uint64_t mask)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(mask);
+#else
+        int position = 0;
+        while ((mask & 1) == 0)
+        {
+            mask >>= 1;
+            ++position;
+        }
+        return position;
+#endif
+    }
+
+    /**
+     * @brief Returns a mask of the bits from the first one up to the last one, excluding the last one.
+     */
+    inline std::uint64_t bit_range(std::size_t first, std::size_t last)
+    {
+        std::uint64_t below_last = (last >= 64) ? ~std::uint64_t(0) : (std::uint64_t(1) << last) - 1;
+        return below_last & ~((std::uint64_t(1) << first) - 1);
+    }
+
+    /**
+     * @brief Finds bytes which may start a delimiter, classifying the text a block at a time.
+     * @note  Words are skipped by the mask of a block, bytes inside of words are never looked at one by one.
+     */
+    class Scanner
+    {
+    private:
+        const unsigned char *bytes;
+        std::size_t size;
+
+        // Start of the classified block and its masks
+        std::size_t block = SIZE_MAX;
+        Delimiters::block_masks masks{};
+
+        // Block classified before the current one, words may start in it
+        std::size_t previous_block = SIZE_MAX;
+        std::uint64_t previous_foldable = 0;
+
+        /**
+         * @brief Classifies the block starting at the position, padding the end of the text by word bytes.
+         */
+        void load(std::size_t start)
+        {
+            this->previous_block = this->block;
+            this->previous_foldable = this->masks.foldable;
+            this->block = start;
+
+            if (start + BLOCK_SIZE <= this->size)
+            {
+                this->masks = classify_block(this->bytes + start);
+                return;
+            }
+
+            unsigned char padded[BLOCK_SIZE] = {};
+            std::memcpy(padded, this->bytes + start, this->size - start);
+            this->masks = classify_block(padded);
+        }
+
+    public:
+        Scanner(const unsigned char *bytes, std::size_t size) : bytes(bytes), size(size) {}
+
+        /**
+         * @brief Finds the first byte at or after the position which may start a delimiter.
+         *
+         * @retval Position of the byte, size of the text if there is none
+         */
+        std::size_t next(std::size_t position)
+        {
+            while (position < this->size)
+            {
+                std::size_t start = position - position % BLOCK_SIZE;
+                if (start != this->block)
+                {
+                    this->load(start);
+                }
+
+                std::uint64_t remaining = this->masks.delimiters >> (position - start);
+                if (remaining != 0)
+                {
+                    return position + lowest_bit(remaining);
+                }
+
+                position = start + BLOCK_SIZE;
+            }
+
+            return this->size;
+        }
+
+        /**
+         * @brief Checks whether case folding leaves the text between the positions unchanged.
+         * @note  Only the current and the previous block are known, longer ranges are reported as changed.
+         *
+         * @param start Position of the first byte
+         * @param end   Position after the last byte, at most one block after the current block
+         *
+         * @retval True if no byte would be changed, false if any byte may be changed
+         */
+        bool is_folded(std::size_t start, std::size_t end) const
+        {
+            if (this->block == SIZE_MAX || end > this->block + BLOCK_SIZE)
+            {
+                return false;
+            }
+
+            if (start >= this->block)
+            {
+                return (this->masks.foldable & bit_range(start - this->block, end - this->block)) == 0;
+            }
+
+            if (this->previous_block != SIZE_MAX && this->previous_block + BLOCK_SIZE == this->block && start >= this->previous_block)
+            {
+                return (this->previous_foldable & bit_range(start - this->previous_block, BLOCK_SIZE)) == 0 &&
+                       (this->masks.foldable & bit_range(0, end - this->block)) == 0;
+            }
+
+            return false;
+        }
+    };
+}; // namespace Delimiters
+
+/**
+ * @brief Single pass tokenizer splitting UTF-8 encoded text into words.
+ * @note  Works directly on the raw bytes, no wide strings are created during tokenization.
+ * @note  Delimiters are . , : ; ! ” „ “ = … ? ( ) space, new line and quote.
+ */
+class Tokenizer
+{
+public:
+    // Position of a single word inside of the tokenized buffer
+    struct Token
+    {
+        std::size_t offset;
+        std::size_t length;
+        // Is the word left unchanged by case folding? May be false even for words which are not changed
+        bool is_folded;
+    };
+
+    /**
+     * @brief Splits the buffer into words and passes each of them to the callback.
+     *
+     * @param data      UTF-8 encoded text
+     * @param size      Size of the text in bytes
+     * @param callback  Called with Tokenizer::Token for every word in order of appearance
+     */
+    template <typename Callback>
+    static void tokenize(const char *data, std::size_t size, Callback &&callback)
+    {
+        tokenize_words(data, size, true, callback);
+    }
+
+    /**
+     * @brief Tokenizer of text which arrives in chunks, for example while a file is being read.
+     * @note  Words crossing the end of a chunk are carried over to the next one.
+     * Only the unfinished word is kept between chunks, never the whole text.
+     */
+    class Stream
+    {
+    private:
+        // Beginning of a word which was not finished by the previous chunk
+        std::string carry;
+
+    public:
+        /**
+         * @brief Tokenizes the next chunk of text.
+         *
+         * @param data      UTF-8 encoded chunk
+         * @param size      Size of the chunk in bytes
+         * @param callback  Called with std::string_view of every finished word
+         */
+        template <typename Callback>
+        void feed(const char *data, std::size_t size, Callback &&callback)
+        {
+            std::size_t offset = 0;
+
+            if (!this->carry.empty())
+            {
+                // The carried word ends at the first delimiter of the chunk
+                // Joined part may also contain a delimiter split between the chunks
+                offset = first_delimiter_end(data, size);
+                this->carry.append(data, offset);
+
+                if (offset == size)
+                {
+                    // Whole chunk is a part of the word
+                    return;
+                }
+
+                tokenize_words(this->carry.data(), this->carry.size(), true, [&](const Token &token) {
+                    callback(std::string_view(this->carry.data() + token.offset, token.length));
+                });
+
+                this->carry.clear();
+            }
+
+            std::size_t consumed = offset + tokenize_words(data + offset, size - offset, false, [&](const Token &token) {
+                                       callback(std::string_view(data + offset + token.offset, token.length));
+                                   });
+
+            this->carry.assign(data + consumed, size - consumed);
+        }
+
+        /**
+         * @brief Finishes the last word after the final chunk.
+         *
+         * @param callback  Called with std::string_view of every remaining word
+         */
+        template <typename Callback>
+        void finish(Callback &&callback)
+        {
+            tokenize_words(this->carry.data(), this->carry.size(), true, [&](const Token &token) {
+                callback(std::string_view(this->carry.data() + token.offset, token.length));
+            });
+
+            this->carry.clear();
+        }
+    };
+
+private:
+    /**
+     * @brief Splits the buffer into words and passes each of them to the callback.
+     *
+     * @param data      UTF-8 encoded text
+     * @param size      Size of the text in bytes
+     * @param is_final  Is the end of the buffer also the end of the text?
+     * @param callback  Called with Tokenizer::Token for every word in order of appearance
+     *
+     * @retval Number of consumed bytes. If the text continues, a word reaching the end of the buffer is not consumed
+     */
+    template <typename Callback>
+    static std::size_t tokenize_words(const char *data, std::size_t size, bool is_final, Callback &&callback)
+    {
+        const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+        Delimiters::Scanner scanner(bytes, size);
+
+        std::size_t i = 0;
+        while (i < size)
+        {
+            // Skips delimiters in front of the word
+            std::size_t delimiter = delimiter_length(bytes, i, size);
+            if (delimiter > 0)
+            {
+                i += delimiter;
+                continue;
+            }
+
+            // Consumes the word until the next delimiter or the end of the buffer
+            // Only bytes marked by the scanner are checked, a lead byte of other characters continues the word
+            std::size_t start = i;
+            do
+            {
+                i = scanner.next(i + 1);
+            } while (i < size && delimiter_length(bytes, i, size) == 0);
+
+            // Word may continue in the next buffer
+            if (i == size && !is_final)
+            {
+                return start;
+            }
+
+            callback(Token{start, i - start, scanner.is_folded(start, i)});
+        }
+
+        return size;
+    }
+
+    /**
+     * @brief Finds the end of the first delimiter in the buffer.
+     *
+     * @retval Position right after the first delimiter, size of the buffer if there is none
+     */
+    static std::size_t first_delimiter_end(const char *data, std::size_t size)
+    {
+        const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+        Delimiters::Scanner scanner(bytes, size);
+
+        for (std::size_t i = scanner.next(0); i < size; i = scanner.next(i + 1))
+        {
+            std::size_t delimiter = delimiter_length(bytes, i, size);
+            if (delimiter > 0)
+            {
+                return i + delimiter;
+            }
+        }
+
+        return size;
+    }
+
+    /**
+     * @brief Checks whether a delimiter starts at the position.
+     *
+     * @retval Length of the delimiter in bytes, 0 if there is no delimiter
+     */
+    static std::size_t delimiter_length(const unsigned char *bytes, std::size_t position, std::size_t size)
+    {
+        std::uint8_t byte_class = Delimiters::byte_classes[bytes[position]];
+
+        if (byte_class == Delimiters::WORD)
+        {
+            return 0;
+        }
+
+        if (byte_class == Delimiters::DELIMITER)
+        {
+            return 1;
+        }
+
+        // ” (E2 80 9D), „ (E2 80 9E), “ (E2 80 9C) and … (E2 80 A6)
+        if (position + 2 < size && bytes[position + 1] == 0x80)
+        {
+            unsigned char last = bytes[position + 2];
+            if (last == 0x9C || last == 0x9D || last == 0x9E || last == 0xA6)
+            {
+                return 3;
+            }
+        }
+
+        return 0;
+    }
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace TopK
+{
+    /**
+     * @brief Selects the best items without sorting all of them.
+     * @note  Keeps a bounded min-heap of the best items found so far, which costs O(n log k) instead of O(n log n).
+     *
+     * @param size      Number of items, items are identified by indices from 0 to size - 1
+     * @param count     Maximum number of selected items
+     * @param is_better Strict ordering of two indices, true if the first item is better
+     *
+     * @return std::vector<std::size_t> Indices of the selected items ordered from the best
+     */
+    template <typename Compare>
+    std::vector<std::size_t> select(std::size_t size, std::size_t count, Compare is_better)
+    {
+        std::vector<std::size_t> heap;
+        heap.reserve(std::min(size, count));
+
+        if (count == 0)
+        {
+            return heap;
+        }
+
+        // With is_better as the heap ordering, the front of the heap is the worst selected item
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            if (heap.size() < count)
+            {
+                heap.push_back(i);
+                std::push_heap(heap.begin(), heap.end(), is_better);
+            }
+            else if (is_better(i, heap.front()))
+            {
+                std::pop_heap(heap.begin(), heap.end(), is_better);
+                heap.back() = i;
+                std::push_heap(heap.begin(), heap.end(), is_better);
+            }
+        }
+
+        // Only the selected items are sorted
+        std::sort_heap(heap.begin(), heap.end(), is_better);
+
+        return heap;
+    }
+}; // namespace TopK
@@ -0,0 +1,156 @@
+#include "utf8.hpp"
+
+namespace
+{
+    /**
+     * @brief Appends a single code point to a wide string.
+     * @note  Code points outside of BMP are split into surrogate pairs where wchar_t is only 16 bits wide.
+     */
+    void append_code_point(std::wstring &result, char32_t code_point)
+    {
+        if (sizeof(wchar_t) == 2 && code_point > 0xFFFF)
+        {
+            code_point -= 0x10000;
+            result += static_cast<wchar_t>(0xD800 + (code_point >> 10));
+            result += static_cast<wchar_t>(0xDC00 + (code_point & 0x3FF));
+        }
+        else
+        {
+            result += static_cast<wchar_t>(code_point);
+        }
+    }
+}; // namespace
+
+char32_t UTF8::decode(std::string_view bytes, std::size_t &position)
+{
+    unsigned char lead = bytes[position];
+
+    // Number of continuation bytes and the smallest code point allowed for the sequence length
+    std::size_t length = 0;
+    char32_t code_point = 0;
+    char32_t minimum = 0;
+
+    if (lead < 0x80)
+    {
+        ++position;
+        return lead;
+    }
+    else if ((lead & 0xE0) == 0xC0)
+    {
+        length = 1;
+        code_point = lead & 0x1F;
+        minimum = 0x80;
+    }
+    else if ((lead & 0xF0) == 0xE0)
+    {
+        length = 2;
+        code_point = lead & 0x0F;
+        minimum = 0x800;
+    }
+    else if ((lead & 0xF8) == 0xF0)
+    {
+        length = 3;
+        code_point = lead & 0x07;
+        minimum = 0x10000;
+    }
+    else
+    {
+        // Stray continuation byte or an invalid lead byte
+        ++position;
+        return REPLACEMENT_CHARACTER;
+    }
+
+    std::size_t j = 1;
+    for (; j <= length && position + j < bytes.size(); ++j)
+    {
+        unsigned char continuation = bytes[position + j];
+        if ((continuation & 0xC0) != 0x80)
+        {
+            break;
+        }
+
+        code_point = (code_point << 6) | (continuation & 0x3F);
+    }
+
+    position += j;
+
+    // Truncated, overlong or out of range sequences are all replaced
+    bool is_valid = j == length + 1 && code_point >= minimum && code_point <= 0x10FFFF && (code_point < 0xD800 || code_point > 0xDFFF);
+    return is_valid ? code_point : REPLACEMENT_CHARACTER;
+}
+
+std::wstring UTF8::decode(std::string_view bytes)
+{
+    std::wstring result;
+    result.reserve(bytes.size());
+
+    std::size_t i = 0;
+    while (i < bytes.size())
+    {
+        unsigned char lead = bytes[i];
+
+        // ASCII is by far the most common case
+        if (lead < 0x80)
+        {
+            result += static_cast<wchar_t>(lead);
+            ++i;
+            continue;
+        }
+
+        append_code_point(result, UTF8::decode(bytes, i));
+    }
+
+    return result;
+}
+
+std::string UTF8::encode(std::wstring_view text)
+{
+    std::string result;
+    result.reserve(text.size());
+
+    UTF8::append(result, text);
+
+    return result;
+}
+
+void UTF8::append(std::string &result, std::wstring_view text)
+{
+    for (std::size_t i = 0; i < text.size(); ++i)
+    {
+        char32_t code_point = static_cast<char32_t>(text[i]);
+
+        // Joins surrogate pairs on platforms with 16 bit wchar_t
+        if (sizeof(wchar_t) == 2 && code_point >= 0xD800 && code_point <= 0xDBFF && i + 1 < text.size())
+        {
+            char32_t low = static_cast<char32_t>(text[i + 1]);
+            if (low >= 0xDC00 && low <= 0xDFFF)
+            {
+                code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+                ++i;
+            }
+        }
+
+        if (code_point < 0x80)
+        {
+            result += static_cast<char>(code_point);
+        }
+        else if (code_point < 0x800)
+        {
+            result += static_cast<char>(0xC0 | (code_point >> 6));
+            result += static_cast<char>(0x80 | (code_point & 0x3F));
+        }
+        else if (code_point < 0x10000)
+        {
+            result += static_cast<char>(0xE0 | (code_point >> 12));
+            result += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+            result += static_cast<char>(0x80 | (code_point & 0x3F));
+        }
+        else
+        {
+            result += static_cast<char>(0xF0 | (code_point >> 18));
+            result += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+            result += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+            result += static_cast<char>(0x80 | (code_point & 0x3F));
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace UTF8
+{
+    // Code point which replaces invalid sequences
+    const char32_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+    /**
+     * @brief Decodes a single code point from UTF-8 encoded bytes.
+     * @note  Invalid sequences are decoded as U+FFFD, at least a single byte is always consumed.
+     * 
+     * @param bytes     UTF-8 encoded text
+     * @param position  Position of the first byte of the code point, moved past its last byte
+     * 
+     * @return char32_t Decoded code point
+     */
+    char32_t decode(std::string_view bytes, std::size_t &position);
+
+    /**
+     * @brief Decodes UTF-8 encoded bytes into a wide string.
+     * @note  Invalid sequences are replaced by U+FFFD instead of throwing.
+     * 
+     * @param bytes UTF-8 encoded text
+     * 
+     * @return std::wstring Decoded text
+     */
+    std::wstring decode(std::string_view bytes);
+
+    /**
+     * @brief Encodes a wide string into UTF-8 bytes.
+     * 
+     * @param text Wide string to be encoded
+     * 
+     * @return std::string UTF-8 encoded text
+     */
+    std::string encode(std::wstring_view text);
+
+    /**
+     * @brief Encodes a wide string into UTF-8 bytes at the end of a buffer.
+     * 
+     * @param result Buffer the encoded text is appended to
+     * @param text   Wide string to be encoded
+     */
+    void append(std::string &result, std::wstring_view text);
+}; // namespace UTF8
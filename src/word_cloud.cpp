@@ -2,51 +2,95 @@
 
 #include <iostream>
 #include <fstream>
-#include <codecvt>
 #include <random>
 #include <algorithm>
-#include <map>
+#include <climits>
+#include <cmath>
 
 // Define max width and height in which a word can be generated
-const int MIN_X = 200;
-const int MAX_X = 1720;
-const int MIN_Y = 100;
-const int MAX_Y = 980;
+const int MIN_X = 20;
+const int MAX_X = SVG::VIEW_WIDTH - 20;
+const int MIN_Y = 20;
+const int MAX_Y = SVG::VIEW_HEIGHT - 20;
+
+const double PI = 3.14159265358979323846;
 
 /**
- * @brief Gets a list of weighted words from total word list.
+ * @brief Moves the text along an Archimedean spiral around the center until it does not overlap any placed text.
+ * @note  Positions outside of the allowed area are rejected by the bounding box before the placed texts are checked.
  * 
- * @param words - Words loaded from a file
+ * @param text  Text to be placed, its position is changed
+ * @param body  SVG body with already placed texts
+ * @param rng   Generator of the starting direction of the spiral
  * 
- * @return std::vector<std::pair<std::wstring, long>> Words with their weights in descending order
+ * @return Was a free position found?
  */
-std::vector<std::pair<std::wstring, long>> get_weighted_words(std::vector<std::wstring> words)
+static bool place_on_spiral(SVG::Text &text, const SVG::Body &body, std::mt19937 &rng)
 {
-    // Assign a weight to each word (number of occurrences)
-    std::map<std::wstring, long> weighted_words;
-    for (const std::wstring word : words)
+    const double center_x = (MIN_X + MAX_X) / 2.0;
+    const double center_y = (MIN_Y + MAX_Y) / 2.0;
+    const double max_radius = std::hypot(MAX_X - MIN_X, MAX_Y - MIN_Y) / 2.0;
+
+    // Distance between turns of the spiral and between tried positions, smaller words are placed more precisely
+    const double step = std::max(4, text.get_height() / 2);
+
+    // Raw output of the generator is the same on every platform, unlike the standard distributions
+    const double start_angle = rng() / 4294967296.0 * 2 * PI;
+
+    // Offsets of the text position from the center of its bounding box
+    const int width = text.get_width();
+    const int baseline_offset = text.y - text.get_y_start() - text.get_height() / 2;
+
+    double angle = 0;
+    double radius = 0;
+    while (radius <= max_radius)
     {
-        if (weighted_words.find(word) == weighted_words.end())
+        text.x = static_cast<int>(std::lround(center_x + radius * std::cos(start_angle + angle))) - width / 2;
+        text.y = static_cast<int>(std::lround(center_y + radius * std::sin(start_angle + angle))) + baseline_offset;
+
+        bool inside = text.x >= MIN_X && text.get_x_end() <= MAX_X && text.get_y_start() >= MIN_Y && text.get_y_end() <= MAX_Y;
+        if (inside && body.get_overlap(text).first == -1)
         {
-            weighted_words.emplace(word, std::count(words.begin(), words.end(), word));
+            return true;
         }
+
+        // Moves by a single step along the arc, each turn moves the spiral outwards by a single step
+        angle += (radius < step) ? 1.0 : step / radius;
+        radius = step * angle / (2 * PI);
     }
 
-    // Order the weighted words into pairs and sort them in descending order by weight
-    std::vector<std::pair<std::wstring, long>> ordered;
-    for (std::map<std::wstring, long>::iterator it = weighted_words.begin(); it != weighted_words.end(); ++it)
+    return false;
+}
+
+std::vector<std::pair<std::string_view, long>> get_weighted_words(const WordCountTable &frequencies, const SymbolTable &symbols)
+{
+    // Weight of each word is its number of occurrences, which is already counted
+    std::vector<WordCountTable::word_count> weighted_ids(frequencies.get_counts().begin(), frequencies.get_counts().end());
+
+    // Sorts the words in descending order by weight, equal weights are ordered by text
+    std::sort(weighted_ids.begin(), weighted_ids.end(),
+              [&symbols](const WordCountTable::word_count &a, const WordCountTable::word_count &b) {
+                  if (a.count != b.count)
+                  {
+                      return a.count > b.count;
+                  }
+
+                  return symbols.get(a.word) < symbols.get(b.word);
+              });
+
+    // Words point into the symbol table, nothing is decoded or copied
+    std::vector<std::pair<std::string_view, long>> ordered;
+    ordered.reserve(weighted_ids.size());
+
+    for (const auto &weighted_id : weighted_ids)
     {
-        ordered.push_back(std::make_pair(it->first, it->second));
+        ordered.push_back(std::make_pair(symbols.get(weighted_id.word), weighted_id.count));
     }
-    std::sort(ordered.begin(), ordered.end(),
-              [](const std::pair<std::wstring, long> &a, std::pair<std::wstring, long> &b) {
-                  return a.second > b.second;
-              });
 
     return ordered;
 }
 
-SVG::Body generate_text(std::vector<std::pair<std::wstring, long>> words)
+SVG::Body generate_text(const std::vector<std::pair<std::string_view, long>> &words, unsigned int seed)
 {
     // Biggest possible word weight
     // Used to calculate font size of words
@@ -58,24 +102,20 @@ SVG::Body generate_text(std::vector<std::pair<std::wstring, long>> words)
     // Text classes
     // Define font size and color
     std::vector<SVG::ClassName> classes{
-        SVG::ClassName{L"top10", L"blue", 128},
-        SVG::ClassName{L"top25", L"dodgerblue", 64},
-        SVG::ClassName{L"top50", L"lightblue", 32},
-        SVG::ClassName{L"top80", L"lightskyblue", 16}};
+        SVG::ClassName{"top10", "blue", 128},
+        SVG::ClassName{"top25", "dodgerblue", 64},
+        SVG::ClassName{"top50", "lightblue", 32},
+        SVG::ClassName{"top80", "lightskyblue", 16}};
     body.set_classes(classes);
 
-    // Random number generators for X and Y coordinates
-    std::random_device dev;
-    std::mt19937 rng(dev());
-    std::uniform_int_distribution<std::mt19937::result_type> rand_x(MIN_X, MAX_X);
-    std::uniform_int_distribution<std::mt19937::result_type> rand_y(MIN_Y, MAX_Y);
+    // Random number generator for starting directions of the spirals
+    std::mt19937 rng(seed);
 
-    // Coordinates, default values are not used
-    int x = 0;
-    int y = 0;
+    // Narrowest text of each class which did not fit, wider texts of the same class are rejected right away
+    std::vector<int> failed_widths(classes.size(), INT_MAX);
 
-    std::pair<std::wstring, long> word;
-    SVG::ClassName currentClass = classes.at(0);
+    std::pair<std::string_view, long> word;
+    std::size_t class_index = 0;
 
     // Current position in input word vector
     unsigned long position = 0;
@@ -87,44 +127,32 @@ SVG::Body generate_text(std::vector<std::pair<std::wstring, long>> words)
         // Changes class based on word weight
         if ((word.second / max) * 100 > max * 0.9)
         {
-            currentClass = classes.at(0);
+            class_index = 0;
         }
         else if ((word.second / max) * 100 > max * 0.75)
         {
-            currentClass = classes.at(1);
+            class_index = 1;
         }
         else if ((word.second / max) * 100 > max * 0.5)
         {
-            currentClass = classes.at(2);
+            class_index = 2;
         }
         else
         {
-            currentClass = classes.at(3);
+            class_index = 3;
         }
 
-        // Generates random position
-        x = rand_x(rng);
-        y = rand_y(rng);
-        SVG::Text text = SVG::Text{word.first, x, y, currentClass};
+        SVG::Text text = SVG::Text{word.first, 0, 0, classes.at(class_index)};
 
-        // If text overlaps with another, try to move it elsewhere
-        std::pair<int, int> overlap = body.get_overlap(text);
-        while (overlap.first > -1)
+        // Words which do not fit anywhere are skipped
+        if (text.get_width() < failed_widths[class_index] && place_on_spiral(text, body, rng))
         {
-            // First trying to move it up along the Y axis
-            text.y += currentClass.font_size;
-
-            // If y is outside defined values, new random position is generated
-            if (text.y > MAX_Y || text.y < MIN_Y)
-            {
-                text.y = rand_y(rng);
-                text.x = rand_x(rng);
-            }
-
-            overlap = body.get_overlap(text);
+            body.add_child(text);
+        }
+        else
+        {
+            failed_widths[class_index] = std::min(failed_widths[class_index], text.get_width());
         }
-
-        body.add_child(text);
 
         // Position is changed at the end of the loop
         // to not start new loop with overflown position in the vector
@@ -134,24 +162,23 @@ SVG::Body generate_text(std::vector<std::pair<std::wstring, long>> words)
     return body;
 }
 
-void create_word_cloud(std::vector<std::wstring> words, std::string file_path)
+void create_word_cloud(const WordCountTable &frequencies, const SymbolTable &symbols, unsigned int seed, std::string file_path)
 {
     try
     {
-        SVG::Body body = generate_text(get_weighted_words(words));
+        SVG::Body body = generate_text(get_weighted_words(frequencies, symbols), seed);
 
-        std::wofstream file_stream(file_path);
-        std::locale loc(std::locale::classic(), new std::codecvt_utf8<wchar_t>);
-        file_stream.imbue(loc);
+        std::string image = body.to_utf8();
 
-        std::vector<std::wstring> image_content = body.to_wstring();
+        // The whole image is written by a single call
+        std::ofstream file_stream(file_path, std::ios::binary);
+        file_stream.write(image.data(), static_cast<std::streamsize>(image.size()));
+        file_stream.close();
 
-        for (auto line : image_content)
+        if (!file_stream)
         {
-            file_stream << line << L"\n";
+            throw std::runtime_error("Could not write " + file_path);
         }
-
-        file_stream.close();
     }
     catch (const std::exception &e)
     {
@@ -1,37 +1,181 @@
 #pragma once
 
+#include "symbol_table.hpp"
+#include "utf8.hpp"
+#include "word_count_table.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
 #include <vector>
 #include <string>
+#include <string_view>
 
 namespace SVG
 {
+    // Size of the SVG view box in pixels
+    const int VIEW_WIDTH = 1920;
+    const int VIEW_HEIGHT = 1080;
+
+    // Size of a single cell of the spatial index in pixels
+    const int GRID_CELL_SIZE = 64;
+
+    // Advance widths of printable ASCII characters (from space to ~) in bold sans-serif, in thousandths of the font size
+    constexpr std::array<std::uint16_t, 95> GLYPH_WIDTHS{
+        278, 333, 474, 556, 556, 889, 722, 238, 333, 333, 389, 584, 278, 333, 278, 278,
+        556, 556, 556, 556, 556, 556, 556, 556, 556, 556, 333, 333, 584, 584, 584, 611,
+        975, 722, 722, 722, 722, 667, 611, 778, 722, 278, 556, 722, 611, 833, 722, 778,
+        667, 778, 722, 667, 611, 722, 667, 944, 667, 667, 611, 333, 278, 333, 584, 556,
+        333, 556, 611, 556, 611, 556, 333, 611, 611, 278, 278, 556, 278, 889, 611, 611,
+        611, 611, 389, 556, 333, 611, 556, 778, 556, 556, 500, 389, 280, 389, 584};
+
+    // Width of characters outside of the table, in thousandths of the font size
+    const int DEFAULT_GLYPH_WIDTH = 611;
+
+    // Height of the font above and below the baseline, in thousandths of the font size
+    const int FONT_ASCENT = 800;
+    const int FONT_DESCENT = 200;
+
+    /**
+     * @brief Approximates the width of a text rendered in bold sans-serif.
+     * @note  Combining marks have no width of their own. Code points are decoded one by one, the text is never copied.
+     * 
+     * @param value     UTF-8 encoded text to be measured
+     * @param font_size Size of the text in pixels
+     * 
+     * @return int Width of the text in pixels
+     */
+    inline int text_width(std::string_view value, int font_size)
+    {
+        long width = 0;
+
+        std::size_t i = 0;
+        while (i < value.size())
+        {
+            unsigned char byte = value[i];
+
+            // ASCII is looked up without decoding
+            if (byte < 0x80)
+            {
+                width += (byte >= 0x20 && byte < 0x7F) ? GLYPH_WIDTHS[byte - 0x20] : DEFAULT_GLYPH_WIDTH;
+                ++i;
+                continue;
+            }
+
+            char32_t character = UTF8::decode(value, i);
+            if (character < 0x300 || character >= 0x370)
+            {
+                width += DEFAULT_GLYPH_WIDTH;
+            }
+        }
+
+        return static_cast<int>((width * font_size + 999) / 1000);
+    }
+
+    /**
+     * @brief Appends a number in decimal notation to a buffer.
+     * 
+     * @param buffer    UTF-8 encoded buffer
+     * @param value     Number to be appended
+     */
+    inline void append_number(std::string &buffer, int value)
+    {
+        char digits[16];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        buffer.append(digits, result.ptr);
+    }
+
+    /**
+     * @brief Appends UTF-8 encoded text to a buffer, escaping characters with special meaning in XML.
+     * @note  Valid UTF-8 is copied as it is, invalid sequences are replaced by U+FFFD so the file stays valid.
+     * 
+     * @param buffer    UTF-8 encoded buffer
+     * @param text      UTF-8 encoded text to be appended
+     */
+    inline void append_escaped(std::string &buffer, std::string_view text)
+    {
+        // Runs of bytes which need no escaping are appended at once
+        std::size_t start = 0;
+
+        std::size_t i = 0;
+        while (i < text.size())
+        {
+            std::size_t position = i++;
+            std::string_view replacement;
+
+            switch (text[position])
+            {
+            case '&':
+                replacement = "&amp;";
+                break;
+            case '<':
+                replacement = "&lt;";
+                break;
+            case '>':
+                replacement = "&gt;";
+                break;
+            case '"':
+                replacement = "&quot;";
+                break;
+            default:
+                if (static_cast<unsigned char>(text[position]) < 0x80)
+                {
+                    continue;
+                }
+
+                i = position;
+                if (UTF8::decode(text, i) != UTF8::REPLACEMENT_CHARACTER)
+                {
+                    continue;
+                }
+
+                // UTF-8 encoding of U+FFFD
+                replacement = "\xEF\xBF\xBD";
+                break;
+            }
+
+            buffer.append(text.substr(start, position - start));
+            buffer.append(replacement);
+            start = i;
+        }
+
+        buffer.append(text.substr(start));
+    }
+
     /**
      * @brief CSS class used for text in SVG files
      */
     class ClassName
     {
     public:
-        std::wstring name;
-        std::wstring color;
+        std::string_view name;
+        std::string_view color;
         int font_size;
 
         /**
          * @brief Constructs a new CSS class for text in SVG files
          * 
-         * @param name      Name of the class
-         * @param color     Color of the text
+         * @param name      Name of the class, usually a literal which outlives the class
+         * @param color     Color of the text, usually a literal which outlives the class
          * @param font_size Size of the text in pixels
          */
-        ClassName(std::wstring name, std::wstring color, int font_size) : name(name), color(color), font_size(font_size) {}
+        ClassName(std::string_view name, std::string_view color, int font_size) : name(name), color(color), font_size(font_size) {}
 
         /**
-         * @brief Converts the class into a wstring
+         * @brief Writes the class into a UTF-8 buffer
          * 
-         * @return std::wstring Valid CSS class notation
+         * @param buffer Buffer the valid CSS class notation is appended to
          */
-        std::wstring to_wstring()
+        void write(std::string &buffer) const
         {
-            return L"." + name + L"{ font: bold " + std::to_wstring(font_size) + L"px sans-serif; fill: " + color + L"; }";
+            buffer += '.';
+            append_escaped(buffer, name);
+            buffer += "{ font: bold ";
+            append_number(buffer, font_size);
+            buffer += "px sans-serif; fill: ";
+            append_escaped(buffer, color);
+            buffer += "; }";
         }
     };
 
@@ -41,71 +185,195 @@ namespace SVG
     class Text
     {
     private:
-        std::wstring value;
+        // UTF-8 encoded text, usually a word in a symbol table
+        std::string_view value;
         SVG::ClassName className;
 
+        // Approximate width of the rendered text in pixels
+        int width;
+
     public:
+        // X position of the start of the text and Y position of its baseline
         int x;
         int y;
 
         /**
          * @brief Construct a new SVG Text element
          * 
-         * @param value     Text to be rendered
+         * @param value     UTF-8 encoded text to be rendered, has to outlive the element
          * @param x         X position
          * @param y         Y position
          * @param className CSS Class
          */
-        Text(std::wstring value, int x, int y, SVG::ClassName className) : value(value), className(className), x(x), y(y) {}
+        Text(std::string_view value, int x, int y, SVG::ClassName className) : value(value), className(className), width(text_width(value, className.font_size)), x(x), y(y) {}
+
+        /**
+         * @brief Writes the element into a UTF-8 buffer
+         * 
+         * @param buffer Buffer the valid SVG Text element is appended to
+         */
+        void write(std::string &buffer) const
+        {
+            buffer += "<text x=\"";
+            append_number(buffer, x);
+            buffer += "\" y=\"";
+            append_number(buffer, y);
+            buffer += "\" class=\"";
+            append_escaped(buffer, className.name);
+            buffer += "\">";
+            append_escaped(buffer, value);
+            buffer += "</text>";
+        }
+
+        /**
+         * @brief Approximates the number of bytes written by write().
+         * 
+         * @return std::size_t Size of the element in bytes, exact for text without escaped characters
+         */
+        std::size_t get_written_size() const
+        {
+            return 48 + className.name.size() + value.size();
+        }
+
+        /**
+         * @brief Returns the approximate width of the rendered text.
+         * 
+         * @return int Width in pixels
+         */
+        int get_width() const
+        {
+            return width;
+        }
 
         /**
-         * @brief Converts the element into a valid wstring
+         * @brief Returns the height of the rendered text including parts below the baseline.
          * 
-         * @return std::wstring Valid SVG Text element
+         * @return int Height in pixels
          */
-        std::wstring to_wstring()
+        int get_height() const
         {
-            return L"<text x=\"" + std::to_wstring(x) + L"\" y=\"" + std::to_wstring(y) + L"\" class=\"" + className.name + L"\">" + value + L"</text>";
+            return get_y_end() - get_y_start();
+        }
+
+        /**
+         * @brief Approximates the end of the text along the X axis.
+         * 
+         * @return int X position where the text ends
+         */
+        int get_x_end() const
+        {
+            return x + width;
+        }
+
+        /**
+         * @brief Approximates the top of the text, which is above the baseline.
+         * 
+         * @return int Y position where the text starts
+         */
+        int get_y_start() const
+        {
+            return y - (className.font_size * FONT_ASCENT + 999) / 1000;
+        }
+
+        /**
+         * @brief Approximates the bottom of the text, which is below the baseline.
+         * 
+         * @return int Y position where the text ends
+         */
+        int get_y_end() const
+        {
+            return y + (className.font_size * FONT_DESCENT + 999) / 1000;
         }
 
         /**
          * @brief Tries to calculate if two SVG Text elements overlap.
-         * @note Due to SVG rendering differently on each platform, it is impossible to calculate text size before render.
-         * @note These calculations are unfortunately a very imprecise aproximation.
+         * @note Sizes are based on glyph widths of a common sans-serif font, other fonts may render slightly differently.
          * 
          * @param text Text elemenet to be checked
          * 
          * @return Do the elements overlap?
          */
-        bool overlaps(SVG::Text text)
+        bool overlaps(const SVG::Text &text) const
         {
-            int x_end = x + (className.font_size * value.length());
-            int y_end = y + className.font_size;
-
-            int other_x_end = text.x + (text.className.font_size * text.value.length());
-            int other_y_end = text.y + text.className.font_size;
-
-            return ((x < text.x && x_end > text.x) || (x < other_x_end && x_end > other_x_end)) && ((y < text.y && y_end > text.y) || (y < other_y_end && y_end > other_y_end));
+            return x < text.get_x_end() && text.x < get_x_end() && get_y_start() < text.get_y_end() && text.get_y_start() < get_y_end();
         }
     };
 
     /**
      * @brief Class for SVG file wrapper and header
+     * @note  Placed children are indexed by a uniform grid, overlap checks only visit the cells covered by the new text.
      */
     class Body
     {
         std::vector<SVG::Text> children;
         std::vector<SVG::ClassName> classes;
 
+        // Indices of children covering each cell of the grid, stored row by row
+        std::vector<std::vector<std::size_t>> cells;
+
+        static const int GRID_COLUMNS = (VIEW_WIDTH + GRID_CELL_SIZE - 1) / GRID_CELL_SIZE;
+        static const int GRID_ROWS = (VIEW_HEIGHT + GRID_CELL_SIZE - 1) / GRID_CELL_SIZE;
+
+        /**
+         * @brief Converts a position to a cell of the grid, positions outside of the view box fall into the border cells.
+         * 
+         * @param position  Position along the axis in pixels
+         * @param cell_count Number of cells along the axis
+         * 
+         * @return int Index of the cell along the axis
+         */
+        static int to_cell(int position, int cell_count)
+        {
+            return std::clamp(position / GRID_CELL_SIZE, 0, cell_count - 1);
+        }
+
+        /**
+         * @brief Calls the function with every cell covered by the text.
+         * 
+         * @param text      SVG Text element
+         * @param function  Called with the index of the cell, stops the iteration when it returns true
+         * 
+         * @return Did the function stop the iteration?
+         */
+        template <typename Function>
+        static bool for_each_cell(const SVG::Text &text, Function &&function)
+        {
+            int first_column = to_cell(text.x, GRID_COLUMNS);
+            int last_column = to_cell(text.get_x_end(), GRID_COLUMNS);
+            int first_row = to_cell(text.get_y_start(), GRID_ROWS);
+            int last_row = to_cell(text.get_y_end(), GRID_ROWS);
+
+            for (int row = first_row; row <= last_row; ++row)
+            {
+                for (int column = first_column; column <= last_column; ++column)
+                {
+                    if (function(static_cast<std::size_t>(row * GRID_COLUMNS + column)))
+                    {
+                        return true;
+                    }
+                }
+            }
+
+            return false;
+        }
+
     public:
+        Body() : cells(GRID_COLUMNS * GRID_ROWS) {}
+
         /**
          * @brief Adds a SVG Text element to be rendered
          * 
          * @param child SVG Text element
          */
-        void add_child(SVG::Text child)
+        void add_child(const SVG::Text &child)
         {
+            std::size_t index = children.size();
             children.push_back(child);
+
+            for_each_cell(child, [&](std::size_t cell) {
+                cells[cell].push_back(index);
+                return false;
+            });
         }
 
         /**
@@ -125,54 +393,115 @@ namespace SVG
          * 
          * @return std::pair<int, int> x and y position of the overlap. (-1, -1) in case of no overlap.
          */
-        std::pair<int, int> get_overlap(SVG::Text new_child)
+        std::pair<int, int> get_overlap(const SVG::Text &new_child) const
         {
-            for (auto child : children)
-            {
-                if (child.overlaps(new_child))
+            const SVG::Text *overlap = nullptr;
+
+            for_each_cell(new_child, [&](std::size_t cell) {
+                for (std::size_t index : cells[cell])
                 {
-                    return std::make_pair(child.x, child.y);
+                    if (children[index].overlaps(new_child))
+                    {
+                        overlap = &children[index];
+                        return true;
+                    }
                 }
+
+                return false;
+            });
+
+            if (overlap == nullptr)
+            {
+                return std::make_pair(-1, -1);
             }
 
-            return std::make_pair(-1, -1);
+            return std::make_pair(overlap->x, overlap->y);
+        }
+
+        /**
+         * @brief Returns the number of placed SVG Text elements.
+         * 
+         * @return std::size_t Number of children
+         */
+        std::size_t size() const
+        {
+            return children.size();
         }
 
         /**
          * @brief Converts the class into a valid SVG file.
+         * @note  The whole file is written into a single preallocated buffer.
          * 
-         * @return std::vector<std::wstring> Valid SVG
+         * @return std::string Valid SVG encoded in UTF-8
          */
-        std::vector<std::wstring> to_wstring()
+        std::string to_utf8() const
         {
-            std::vector<std::wstring> image;
+            std::size_t size = 512;
+            for (const SVG::Text &child : children)
+            {
+                size += child.get_written_size();
+            }
+
+            std::string image;
+            image.reserve(size);
 
-            image.push_back(L"<?xml version=\"1.0\" encoding=\"UTF-8\"?>");
-            image.push_back(L"<svg xmlns=\"http://www.w3.org/2000/svg\" viewBox=\"0 0 1920 1080\" style=\"background-color:white\">");
+            image += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+            image += "<svg xmlns=\"http://www.w3.org/2000/svg\" viewBox=\"0 0 ";
+            append_number(image, VIEW_WIDTH);
+            image += ' ';
+            append_number(image, VIEW_HEIGHT);
+            image += "\" style=\"background-color:white\">\n";
 
-            image.push_back(L"<style>");
-            for (auto &className : classes)
+            image += "<style>\n";
+            for (const auto &className : classes)
             {
-                image.push_back(className.to_wstring());
+                className.write(image);
+                image += '\n';
             }
-            image.push_back(L"</style>");
+            image += "</style>\n";
 
-            for (SVG::Text &child : children)
+            for (const SVG::Text &child : children)
             {
-                image.push_back(child.to_wstring());
+                child.write(image);
+                image += '\n';
             }
 
-            image.push_back(L"</svg>");
+            image += "</svg>\n";
 
             return image;
         }
     };
 }; // namespace SVG
 
+/**
+ * @brief Gets a list of weighted words from precomputed word counts.
+ * @note  Every counted word is weighted, filtered out words have to be left out of the counts beforehand.
+ * @note  Only the distinct words are sorted by weight, in O(u log u) for u distinct words. The corpus is never scanned again.
+ * 
+ * @param frequencies   Number of occurrences of every distinct word
+ * @param symbols       Symbol table with the text of the word IDs, has to outlive the returned words
+ * 
+ * @return std::vector<std::pair<std::string_view, long>> UTF-8 encoded words of the symbol table with their weights in descending order
+ */
+std::vector<std::pair<std::string_view, long>> get_weighted_words(const WordCountTable &frequencies, const SymbolTable &symbols);
+
+/**
+ * @brief Places the most weighted words into a SVG body.
+ * @note  Every word is moved along an Archimedean spiral from the center until it does not overlap any placed word.
+ * 
+ * @param words UTF-8 encoded words with their weights in descending order, have to outlive the body
+ * @param seed  Seed of the starting directions of the spirals, equal seeds produce equal layouts
+ * 
+ * @return SVG::Body SVG with placed words
+ */
+SVG::Body generate_text(const std::vector<std::pair<std::string_view, long>> &words, unsigned int seed);
+
 /**
  * @brief Generates a SVG file with word cloud into a specified file path.
  * 
- * @param words     Words used to generate the word cloud
- * @param file_path Target file path
+ * @param frequencies   Number of occurrences of every distinct word
+ * @param symbols       Symbol table with the text of the word IDs
+ * @param seed          Seed of the layout
+ * @param file_path     Target file path
  */
-void create_word_cloud(std::vector<std::wstring> words, std::string file_path);
\ No newline at end of file
+void create_word_cloud(const WordCountTable &frequencies, const SymbolTable &symbols, unsigned int seed, std::string file_path);
@@ -0,0 +1,81 @@
+#include "word_count_table.hpp"
+
+#include <algorithm>
+
+WordCountTable::WordCountTable(const std::vector<std::uint32_t> &words, std::size_t symbol_count)
+{
+    // IDs are dense, so the counts are kept in a vector indexed by ID
+    std::vector<long> counts(symbol_count, 0);
+    for (auto word : words)
+    {
+        ++counts[word];
+    }
+
+    *this = WordCountTable(counts);
+}
+
+WordCountTable::WordCountTable(const std::vector<long> &counts)
+{
+    for (std::uint32_t id = 0; id < counts.size(); ++id)
+    {
+        if (counts[id] > 0)
+        {
+            this->counts.push_back(WordCountTable::word_count{id, counts[id]});
+        }
+    }
+}
+
+WordCountTable::WordCountTable(std::vector<WordCountTable::word_count> counts) : counts(std::move(counts))
+{
+}
+
+void WordCountTable::merge(const WordCountTable &other)
+{
+    std::vector<WordCountTable::word_count> merged;
+    merged.reserve(this->counts.size() + other.counts.size());
+
+    // Both tables are sorted by ID, so a single pass over both is enough
+    auto a = this->counts.begin();
+    auto b = other.counts.begin();
+
+    while (a != this->counts.end() && b != other.counts.end())
+    {
+        if (a->word < b->word)
+        {
+            merged.push_back(*a++);
+        }
+        else if (b->word < a->word)
+        {
+            merged.push_back(*b++);
+        }
+        else
+        {
+            merged.push_back(WordCountTable::word_count{a->word, a->count + b->count});
+            ++a;
+            ++b;
+        }
+    }
+
+    merged.insert(merged.end(), a, this->counts.end());
+    merged.insert(merged.end(), b, other.counts.end());
+
+    this->counts = std::move(merged);
+}
+
+void WordCountTable::remap(const std::vector<std::uint32_t> &remap)
+{
+    for (auto &count : this->counts)
+    {
+        count.word = remap[count.word];
+    }
+
+    std::sort(this->counts.begin(), this->counts.end(),
+              [](const WordCountTable::word_count &a, const WordCountTable::word_count &b) {
+                  return a.word < b.word;
+              });
+}
+
+const std::vector<WordCountTable::word_count> &WordCountTable::get_counts() const
+{
+    return this->counts;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Numbers of occurrences of distinct words, kept sorted by word ID.
+ * @note  Sorted tables are merged in linear time, which makes them cheap to combine across files.
+ */
+class WordCountTable
+{
+public:
+    // Number of occurrences of a single distinct word
+    struct word_count
+    {
+        std::uint32_t word;
+        long count;
+    };
+
+private:
+    std::vector<WordCountTable::word_count> counts;
+
+public:
+    WordCountTable() = default;
+
+    /**
+     * @brief Counts the occurrences of every word in a sequence.
+     *
+     * @param words         Sequence of word IDs
+     * @param symbol_count  Number of IDs in the symbol table, every ID has to be lower
+     */
+    WordCountTable(const std::vector<std::uint32_t> &words, std::size_t symbol_count);
+
+    /**
+     * @brief Creates the table from counts indexed by word ID.
+     *
+     * @param counts Number of occurrences of every ID, IDs with zero count are skipped
+     */
+    explicit WordCountTable(const std::vector<long> &counts);
+
+    /**
+     * @brief Creates the table from counts which are already sorted by word ID.
+     *
+     * @param counts Counts of distinct words sorted by word ID
+     */
+    explicit WordCountTable(std::vector<WordCountTable::word_count> counts);
+
+    /**
+     * @brief Adds the counts of another table to this one.
+     * @note  Both tables have to use IDs from the same symbol table.
+     *
+     * @param other Table to be merged
+     */
+    void merge(const WordCountTable &other);
+
+    /**
+     * @brief Replaces every word ID with a new one and sorts the table again.
+     *
+     * @param remap New ID for every old ID
+     */
+    void remap(const std::vector<std::uint32_t> &remap);
+
+    /**
+     * @brief Returns the counts of all distinct words.
+     *
+     * @return const std::vector<WordCountTable::word_count>& Counts sorted by word ID
+     */
+    const std::vector<WordCountTable::word_count> &get_counts() const;
+};